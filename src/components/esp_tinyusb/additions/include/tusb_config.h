@@ -53,6 +53,10 @@ extern "C" {
 #   define CONFIG_TINYUSB_MIDI_COUNT 0
 #endif
 
+#ifndef CONFIG_TINYUSB_VENDOR_ENABLED
+#   define CONFIG_TINYUSB_VENDOR_ENABLED 0
+#endif
+
 #ifndef CONFIG_TINYUSB_CUSTOM_CLASS_ENABLED
 #   define CONFIG_TINYUSB_CUSTOM_CLASS_ENABLED 0
 #endif
@@ -86,6 +90,10 @@ extern "C" {
 // MSC Buffer size of Device Mass storage
 #define CFG_TUD_MSC_BUFSIZE         CONFIG_TINYUSB_MSC_BUFSIZE
 
+// Vendor FIFO size of TX and RX
+#define CFG_TUD_VENDOR_RX_BUFSIZE   CONFIG_TINYUSB_VENDOR_RX_BUFSIZE
+#define CFG_TUD_VENDOR_TX_BUFSIZE   CONFIG_TINYUSB_VENDOR_TX_BUFSIZE
+
 #define CFG_TUD_MIDI_EP_BUFSIZE     64
 #define CFG_TUD_MIDI_EPSIZE         CFG_TUD_MIDI_EP_BUFSIZE
 #define CFG_TUD_MIDI_RX_BUFSIZE     64
@@ -96,6 +104,7 @@ extern "C" {
 #define CFG_TUD_MSC                 CONFIG_TINYUSB_MSC_ENABLED
 #define CFG_TUD_HID                 CONFIG_TINYUSB_HID_COUNT
 #define CFG_TUD_MIDI                CONFIG_TINYUSB_MIDI_COUNT
+#define CFG_TUD_VENDOR              CONFIG_TINYUSB_VENDOR_ENABLED
 #define CFG_TUD_CUSTOM_CLASS        CONFIG_TINYUSB_CUSTOM_CLASS_ENABLED
 
 #ifdef __cplusplus
@@ -15,7 +15,7 @@
  *   [MSB]         HID | MSC | CDC          [LSB]
  */
 #define USB_TUSB_PID (0x4000 | _PID_MAP(CDC, 0) | _PID_MAP(MSC, 1) | _PID_MAP(HID, 2) | \
-    _PID_MAP(MIDI, 3) ) //| _PID_MAP(AUDIO, 4) | _PID_MAP(VENDOR, 5) )
+    _PID_MAP(MIDI, 3) | _PID_MAP(VENDOR, 5) ) //| _PID_MAP(AUDIO, 4) )
 
 /**** TinyUSB default ****/
 tusb_desc_device_t descriptor_tinyusb = {
@@ -117,6 +117,12 @@ tusb_desc_strarray_device_t descriptor_str_kconfig = {
     "",
 #endif
 
+#if CONFIG_TINYUSB_VENDOR_ENABLED
+    CONFIG_TINYUSB_DESC_VENDOR_STRING,       // 6: Vendor Interface
+#else
+    "",
+#endif
+
 };
 
 //------------- Configuration Descriptor -------------//
@@ -135,13 +141,18 @@ enum {
     ITF_NUM_MSC,
 #endif
 
+#if CFG_TUD_VENDOR
+    ITF_NUM_VENDOR,
+#endif
+
     ITF_NUM_TOTAL
 };
 
 enum {
     TUSB_DESC_TOTAL_LEN = TUD_CONFIG_DESC_LEN +
                         CFG_TUD_CDC * TUD_CDC_DESC_LEN +
-                        CFG_TUD_MSC * TUD_MSC_DESC_LEN
+                        CFG_TUD_MSC * TUD_MSC_DESC_LEN +
+                        CFG_TUD_VENDOR * TUD_VENDOR_DESC_LEN
 };
 
 //------------- USB Endpoint numbers -------------//
@@ -161,6 +172,10 @@ enum {
 #if CFG_TUD_MSC
     EPNUM_MSC,
 #endif
+
+#if CFG_TUD_VENDOR
+    EPNUM_VENDOR,
+#endif
 };
 
 uint8_t const descriptor_cfg_kconfig[] = {
@@ -181,6 +196,11 @@ uint8_t const descriptor_cfg_kconfig[] = {
     // Interface number, string index, EP Out & EP In address, EP size
     TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, 5, EPNUM_MSC, 0x80 | EPNUM_MSC, 64), // highspeed 512
 #endif
+
+#if CFG_TUD_VENDOR
+    // Interface number, string index, EP Out & IN address, EP size
+    TUD_VENDOR_DESCRIPTOR(ITF_NUM_VENDOR, 6, EPNUM_VENDOR, 0x80 | EPNUM_VENDOR, 64),
+#endif
 };
 
 /* End of Kconfig driven Descriptor */
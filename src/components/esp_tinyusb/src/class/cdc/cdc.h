@@ -397,6 +397,21 @@ typedef struct TU_ATTR_PACKED
 
 TU_VERIFY_STATIC(sizeof(cdc_line_control_state_t) == 2, "size is not correct");
 
+/// 6.5.4 SerialState notification bitmap (PSTN)
+typedef struct TU_ATTR_PACKED
+{
+  uint16_t rx_carrier  : 1; ///< bRxCarrier, state of receiver carrier detection mechanism of device. RS-232 signal DCD.
+  uint16_t tx_carrier  : 1; ///< bTxCarrier, state of transmission carrier. RS-232 signal DSR.
+  uint16_t brk         : 1; ///< bBreak, state of break detection mechanism of the device.
+  uint16_t ring_signal : 1; ///< bRingSignal, state of ring signal detection of the device.
+  uint16_t framing     : 1; ///< bFraming, a framing error has occurred.
+  uint16_t parity      : 1; ///< bParity, a parity error has occurred.
+  uint16_t overrun     : 1; ///< bOverRun, received data has been discarded due to overrun in the device.
+  uint16_t : 9;
+} cdc_serial_state_t;
+
+TU_VERIFY_STATIC(sizeof(cdc_serial_state_t) == 2, "size is not correct");
+
 TU_ATTR_PACKED_END  // End of all packed definitions
 TU_ATTR_BIT_FIELD_ORDER_END
 
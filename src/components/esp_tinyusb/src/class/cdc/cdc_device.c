@@ -71,6 +71,9 @@ typedef struct
   CFG_TUSB_MEM_ALIGN uint8_t epout_buf[CFG_TUD_CDC_EP_BUFSIZE];
   CFG_TUSB_MEM_ALIGN uint8_t epin_buf[CFG_TUD_CDC_EP_BUFSIZE];
 
+  // Notification transfer buffer: 8 byte request header + 2 byte SERIAL_STATE bitmap
+  CFG_TUSB_MEM_ALIGN uint8_t epnotif_buf[10];
+
 }cdcd_interface_t;
 
 #define ITF_MEM_RESET_SIZE   offsetof(cdcd_interface_t, wanted_char)
@@ -128,6 +131,11 @@ void tud_cdc_n_get_line_coding (uint8_t itf, cdc_line_coding_t* coding)
   (*coding) = _cdcd_itf[itf].line_coding;
 }
 
+void tud_cdc_n_set_line_coding (uint8_t itf, cdc_line_coding_t const* coding)
+{
+  _cdcd_itf[itf].line_coding = (*coding);
+}
+
 void tud_cdc_n_set_wanted_char (uint8_t itf, char wanted)
 {
   _cdcd_itf[itf].wanted_char = wanted;
@@ -220,6 +228,42 @@ bool tud_cdc_n_write_clear (uint8_t itf)
   return tu_fifo_clear(&_cdcd_itf[itf].tx_ff);
 }
 
+//--------------------------------------------------------------------+
+// NOTIFICATION API
+//--------------------------------------------------------------------+
+bool tud_cdc_n_send_serial_state (uint8_t itf, uint16_t serial_state)
+{
+  cdcd_interface_t* p_cdc = &_cdcd_itf[itf];
+  uint8_t const rhport = TUD_OPT_RHPORT;
+
+  // skip if usb is not ready or the interface has no notification endpoint
+  TU_VERIFY( tud_ready() && p_cdc->ep_notif );
+
+  // previous notification is still pending, caller retries with the latest state
+  TU_VERIFY( usbd_edpt_claim(rhport, p_cdc->ep_notif) );
+
+  uint8_t* buf = p_cdc->epnotif_buf;
+  buf[0] = 0xA1; // Device to host, class, interface
+  buf[1] = CDC_NOTIF_SERIAL_STATE;
+  buf[2] = 0;    // wValue
+  buf[3] = 0;
+  buf[4] = p_cdc->itf_num; // wIndex
+  buf[5] = 0;
+  buf[6] = 2;    // wLength
+  buf[7] = 0;
+  buf[8] = TU_U16_LOW(serial_state);
+  buf[9] = TU_U16_HIGH(serial_state);
+
+  if ( !usbd_edpt_xfer(rhport, p_cdc->ep_notif, buf, sizeof(p_cdc->epnotif_buf)) )
+  {
+    // Release endpoint since the transfer was not queued, or later notifications never go out
+    usbd_edpt_release(rhport, p_cdc->ep_notif);
+    return false;
+  }
+
+  return true;
+}
+
 //--------------------------------------------------------------------+
 // USBD Driver API
 //--------------------------------------------------------------------+
@@ -428,10 +472,13 @@ bool cdcd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_
   for (itf = 0; itf < CFG_TUD_CDC; itf++)
   {
     p_cdc = &_cdcd_itf[itf];
-    if ( ( ep_addr == p_cdc->ep_out ) || ( ep_addr == p_cdc->ep_in ) ) break;
+    if ( ( ep_addr == p_cdc->ep_out ) || ( ep_addr == p_cdc->ep_in ) || ( ep_addr == p_cdc->ep_notif ) ) break;
   }
   TU_ASSERT(itf < CFG_TUD_CDC);
 
+  // Notification sent, nothing more to do
+  if ( ep_addr == p_cdc->ep_notif ) return true;
+
   // Received new data
   if ( ep_addr == p_cdc->ep_out )
   {
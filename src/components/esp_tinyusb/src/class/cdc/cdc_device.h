@@ -65,6 +65,9 @@ uint8_t  tud_cdc_n_get_line_state  (uint8_t itf);
 // Get current line encoding: bit rate, stop bits parity etc ..
 void     tud_cdc_n_get_line_coding (uint8_t itf, cdc_line_coding_t* coding);
 
+// Set line encoding reported to host on GET_LINE_CODING, e.g. when device detected it, no callback is invoked
+void     tud_cdc_n_set_line_coding (uint8_t itf, cdc_line_coding_t const* coding);
+
 // Set special character that will trigger tud_cdc_rx_wanted_cb() callback on receiving
 void     tud_cdc_n_set_wanted_char (uint8_t itf, char wanted);
 
@@ -104,6 +107,10 @@ uint32_t tud_cdc_n_write_available (uint8_t itf);
 // Clear the transmit FIFO
 bool tud_cdc_n_write_clear (uint8_t itf);
 
+// Send SERIAL_STATE notification (bitmap of cdc_serial_state_t) on the notification endpoint,
+// return false if usb is not ready or the previous notification is still in flight
+bool tud_cdc_n_send_serial_state (uint8_t itf, uint16_t serial_state);
+
 //--------------------------------------------------------------------+
 // Application API (Single Port)
 //--------------------------------------------------------------------+
@@ -124,6 +131,7 @@ static inline uint32_t tud_cdc_write_str       (char const* str);
 static inline uint32_t tud_cdc_write_flush     (void);
 static inline uint32_t tud_cdc_write_available (void);
 static inline bool     tud_cdc_write_clear     (void);
+static inline bool     tud_cdc_send_serial_state (uint16_t serial_state);
 
 //--------------------------------------------------------------------+
 // Application Callback API (weak is optional)
@@ -241,6 +249,11 @@ static inline bool tud_cdc_write_clear(void)
   return tud_cdc_n_write_clear(0);
 }
 
+static inline bool tud_cdc_send_serial_state(uint16_t serial_state)
+{
+  return tud_cdc_n_send_serial_state(0, serial_state);
+}
+
 /** @} */
 /** @} */
 
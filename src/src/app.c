@@ -47,8 +47,13 @@
 #include "commons.h"
 #include "app_uart.h"
 #include "app_tusb.h"
-#include "app_espnow.h"
+#include "app_link.h"
+#include "app_relay.h"
+#include "app_sniffer.h"
 #include "app_conn.h"
+#include "app_tsync.h"
+#include "app_tdma.h"
+#include "app_txpwr.h"
 #include "led.h"
 #include "app.h"
 
@@ -59,7 +64,7 @@
  * @{
  */
 
-#if (((DEVICE_WISER_USB) && (DEVICE_WISER_UART)) || (!(DEVICE_WISER_USB) && !(DEVICE_WISER_UART)))
+#if ((DEVICE_WISER_USB) + (DEVICE_WISER_UART) + (DEVICE_WISER_RELAY) + (DEVICE_WISER_SNIFFER)) != 1
     #error Device mode configuration is not correct!
 #endif
 
@@ -100,9 +105,13 @@
 int app_init(void) 
 {
     led_init();
-    
+
+#if DEVICE_WISER_SNIFFER
+    // sniffer only listens, link modules stay down so it never disturbs the pair
+    return app_sniffer_init();
+#endif
     vTaskDelay(50);
-    app_espnow_init();
+    app_link_init();
     vTaskDelay(100);
 
 #if DEVICE_WISER_UART
@@ -112,6 +121,9 @@ int app_init(void)
     app_tusb_init();
 #endif
     app_conn_init();
+    app_tsync_init();
+    app_tdma_init();
+    app_txpwr_init();
     return ESP_OK;
 }
 
@@ -0,0 +1,415 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_aead.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application link frame encryption module which seals link frames with AES-GCM
+ *
+ * Frames are encrypted above the transport, so any number of peers and broadcast frames
+ * share one group key instead of using the ESP-NOW per peer LMK slots. AES-GCM runs on the
+ * AES accelerator through mbedtls (CONFIG_MBEDTLS_HARDWARE_GCM). The nonce is the low four
+ * bytes of the sender MAC address, a key epoch which is advanced in NVS on every start and
+ * a frame counter, so no nonce is used twice under the key.
+ */
+
+/**
+ * @defgroup app_aead Application link frame encryption Module
+ * @brief Module for authenticated encryption of link frames with AES-GCM
+ * @{
+ */
+
+/**
+ * @addtogroup app_aead_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_timer.h"
+#include "mbedtls/gcm.h"
+#include "nvs_peer.h"
+#include "app_aead.h"
+
+/** @} */ // End of app_aead_include group
+
+/**
+ * @addtogroup app_aead_define
+ * @{
+ */
+
+/* group key used when none is stored under "link_key" in NVS */
+#define CONFIG_LINK_AEAD_KEY    "REPLACE_WITH_KEY"
+
+/** @} */ // End of app_aead_define group
+
+/**
+ * @addtogroup app_aead_types
+ * @{
+ */
+
+/* replay state of one sender */
+typedef struct {
+    bool used;
+    uint32_t id;            /**< low four bytes of sender MAC address */
+    uint32_t epoch;         /**< latest key epoch of sender */
+    uint32_t top;           /**< highest frame counter accepted in epoch */
+    uint32_t window;        /**< bit n set if frame counter top - n was accepted */
+    uint32_t last_heard;    /**< frames_opened count when sender was last heard */
+} app_aead_sender_t;
+
+/** @} */ // End of app_aead_types group
+
+/**
+ * @addtogroup app_aead_static_vars
+ * @{
+ */
+
+/**
+ * @brief Tag used for logging in this module
+ */
+static const char *TAG = "app_aead";
+
+/* separate contexts so sealing in send path and opening in receive path never share state */
+static mbedtls_gcm_context s_app_aead_seal_ctx;
+static mbedtls_gcm_context s_app_aead_open_ctx;
+
+static uint32_t s_app_aead_id = 0;
+static uint32_t s_app_aead_epoch = 0;
+static uint32_t s_app_aead_counter = 0;
+
+static app_aead_sender_t s_app_aead_senders[APP_AEAD_SENDER_MAX];
+static app_aead_stats_t s_app_aead_stats;
+
+/** @} */ // End of app_aead_static_vars group
+
+/**
+ * @addtogroup app_aead_static_funcs
+ * @{
+ */
+
+/**
+ * @brief advances key epoch in NVS and restarts frame counter
+ *
+ * @return esp error code
+ */
+static esp_err_t app_aead_epoch_next(void);
+
+/**
+ * @brief finds replay state of a sender
+ *
+ * @param id sender id
+ * @return sender replay state, NULL if sender is not known
+ */
+static app_aead_sender_t *app_aead_sender_find(uint32_t id);
+
+/**
+ * @brief adds replay state of a sender, taking over the least recently heard slot when full
+ *
+ * @param id sender id
+ * @return sender replay state
+ */
+static app_aead_sender_t *app_aead_sender_add(uint32_t id);
+
+/**
+ * @brief checks if a frame counter of sender was not accepted before
+ *
+ * @param sender sender replay state, NULL if sender is not known
+ * @param epoch key epoch of frame
+ * @param counter frame counter of frame
+ * @return true if frame is new
+ */
+static bool app_aead_replay_check(const app_aead_sender_t *sender, uint32_t epoch, uint32_t counter);
+
+/**
+ * @brief records an authenticated frame counter of sender
+ *
+ * @param id sender id
+ * @param sender sender replay state, NULL if sender is not known
+ * @param epoch key epoch of frame
+ * @param counter frame counter of frame
+ */
+static void app_aead_replay_update(uint32_t id, app_aead_sender_t *sender, uint32_t epoch, uint32_t counter);
+
+/** @} */ // End of app_aead_static_funcs group
+
+/**
+ * @addtogroup app_aead_static_funcs
+ * @{
+ */
+
+/**
+ * @brief advances key epoch in NVS and restarts frame counter
+ *
+ * @return esp error code
+ */
+static esp_err_t app_aead_epoch_next(void)
+{
+    if(!nvs_peer_aead_epoch_next(&s_app_aead_epoch)) {
+        ESP_LOGE(TAG, "key epoch not stored, encryption disabled");
+        return ESP_FAIL;
+    }
+    s_app_aead_counter = 0;
+    ESP_LOGE(TAG, "key epoch: %lu", (unsigned long)s_app_aead_epoch);
+    return ESP_OK;
+}
+
+/**
+ * @brief finds replay state of a sender
+ *
+ * @param id sender id
+ * @return sender replay state, NULL if sender is not known
+ */
+static app_aead_sender_t *app_aead_sender_find(uint32_t id)
+{
+    for(int i = 0; i < APP_AEAD_SENDER_MAX; i++) {
+        if(s_app_aead_senders[i].used && s_app_aead_senders[i].id == id) {
+            return &s_app_aead_senders[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief adds replay state of a sender, taking over the least recently heard slot when full
+ *
+ * @param id sender id
+ * @return sender replay state
+ */
+static app_aead_sender_t *app_aead_sender_add(uint32_t id)
+{
+    app_aead_sender_t *slot = &s_app_aead_senders[0];
+    uint32_t now = s_app_aead_stats.frames_opened;
+
+    for(int i = 0; i < APP_AEAD_SENDER_MAX; i++) {
+        app_aead_sender_t *sender = &s_app_aead_senders[i];
+        if(!sender->used) {
+            slot = sender;
+            break;
+        }
+        if((now - sender->last_heard) > (now - slot->last_heard)) {
+            slot = sender;
+        }
+    }
+    memset(slot, 0, sizeof(*slot));
+    slot->id = id;
+    return slot;
+}
+
+/**
+ * @brief checks if a frame counter of sender was not accepted before
+ *
+ * @param sender sender replay state, NULL if sender is not known
+ * @param epoch key epoch of frame
+ * @param counter frame counter of frame
+ * @return true if frame is new
+ */
+static bool app_aead_replay_check(const app_aead_sender_t *sender, uint32_t epoch, uint32_t counter)
+{
+    if(sender == NULL || epoch > sender->epoch) {
+        return true;
+    }
+    if(epoch < sender->epoch) {
+        return false;
+    }
+    if(counter > sender->top) {
+        return true;
+    }
+    uint32_t age = sender->top - counter;
+    return (age < APP_AEAD_REPLAY_WINDOW) && !(sender->window & (1UL << age));
+}
+
+/**
+ * @brief records an authenticated frame counter of sender
+ *
+ * @param id sender id
+ * @param sender sender replay state, NULL if sender is not known
+ * @param epoch key epoch of frame
+ * @param counter frame counter of frame
+ */
+static void app_aead_replay_update(uint32_t id, app_aead_sender_t *sender, uint32_t epoch, uint32_t counter)
+{
+    // senders only take a slot once authenticated, so forged frames cannot push out known senders
+    if(sender == NULL) {
+        sender = app_aead_sender_add(id);
+    }
+    if(!sender->used || epoch != sender->epoch) {
+        sender->used = true;
+        sender->epoch = epoch;
+        sender->top = counter;
+        sender->window = 1;
+    } else if(counter > sender->top) {
+        uint32_t shift = counter - sender->top;
+        sender->window = (shift < APP_AEAD_REPLAY_WINDOW) ? ((sender->window << shift) | 1) : 1;
+        sender->top = counter;
+    } else {
+        sender->window |= (1UL << (sender->top - counter));
+    }
+    sender->last_heard = s_app_aead_stats.frames_opened;
+}
+
+/** @} */ // End of app_aead_static_funcs group
+
+/**
+ * @addtogroup app_aead_global_funcs
+ * @{
+ */
+
+/**
+ * @brief loads link key and starts a new key epoch, NVS storage handle must be open
+ *
+ * @return esp error code
+ */
+esp_err_t app_aead_init(void)
+{
+    uint8_t key[APP_AEAD_KEY_LEN];
+    uint8_t own_mac[6];
+
+    if(!nvs_peer_key_read(key, sizeof(key))) {
+        memcpy(key, CONFIG_LINK_AEAD_KEY, sizeof(key));
+    }
+    esp_read_mac(own_mac, ESP_MAC_WIFI_STA);
+    memcpy(&s_app_aead_id, &own_mac[2], sizeof(s_app_aead_id));
+
+    mbedtls_gcm_init(&s_app_aead_seal_ctx);
+    mbedtls_gcm_init(&s_app_aead_open_ctx);
+    if(mbedtls_gcm_setkey(&s_app_aead_seal_ctx, MBEDTLS_CIPHER_ID_AES, key, APP_AEAD_KEY_LEN * 8) != 0 ||
+       mbedtls_gcm_setkey(&s_app_aead_open_ctx, MBEDTLS_CIPHER_ID_AES, key, APP_AEAD_KEY_LEN * 8) != 0) {
+        ESP_LOGE(TAG, "set key fail");
+        memset(key, 0, sizeof(key));
+        return ESP_FAIL;
+    }
+    memset(key, 0, sizeof(key));
+    return app_aead_epoch_next();
+}
+
+/**
+ * @brief encrypts and authenticates one link frame
+ *
+ * @param in frame bytes
+ * @param len length of frame
+ * @param out buffer for sealed frame, at least len + APP_AEAD_OVERHEAD bytes
+ * @param out_size size of out buffer
+ * @param out_len length of sealed frame
+ * @return esp error code
+ */
+esp_err_t app_aead_seal(const uint8_t *in, size_t len, uint8_t *out, size_t out_size, size_t *out_len)
+{
+    if(len + APP_AEAD_OVERHEAD > out_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // counter exhausted, the epoch must move on before the nonce repeats
+    if(s_app_aead_counter == UINT32_MAX) {
+        nvs_peer_open();
+        esp_err_t err = app_aead_epoch_next();
+        nvs_peer_close();
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+    int64_t start = esp_timer_get_time();
+    memcpy(&out[0], &s_app_aead_id, sizeof(uint32_t));
+    memcpy(&out[4], &s_app_aead_epoch, sizeof(uint32_t));
+    memcpy(&out[8], &s_app_aead_counter, sizeof(uint32_t));
+    s_app_aead_counter++;
+
+    if(mbedtls_gcm_crypt_and_tag(&s_app_aead_seal_ctx, MBEDTLS_GCM_ENCRYPT, len, out, APP_AEAD_NONCE_LEN, NULL, 0,
+                                 in, &out[APP_AEAD_NONCE_LEN], APP_AEAD_TAG_LEN, &out[APP_AEAD_NONCE_LEN + len]) != 0) {
+        return ESP_FAIL;
+    }
+    *out_len = len + APP_AEAD_OVERHEAD;
+
+    s_app_aead_stats.frames_sealed++;
+    s_app_aead_stats.bytes += len;
+    s_app_aead_stats.time_us += (uint32_t)(esp_timer_get_time() - start);
+    return ESP_OK;
+}
+
+/**
+ * @brief authenticates and decrypts one sealed link frame, rejecting replayed frames
+ *
+ * @param in sealed frame bytes
+ * @param len length of sealed frame
+ * @param out buffer for frame, at least len - APP_AEAD_OVERHEAD bytes
+ * @param out_len length of frame
+ * @return esp error code
+ */
+esp_err_t app_aead_open(const uint8_t *in, size_t len, uint8_t *out, size_t *out_len)
+{
+    uint32_t id, epoch, counter;
+
+    if(len <= APP_AEAD_OVERHEAD) {
+        s_app_aead_stats.frames_rejected++;
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&id, &in[0], sizeof(uint32_t));
+    memcpy(&epoch, &in[4], sizeof(uint32_t));
+    memcpy(&counter, &in[8], sizeof(uint32_t));
+
+    // own frames come back in broadcast mode
+    if(id == s_app_aead_id) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    app_aead_sender_t *sender = app_aead_sender_find(id);
+    if(!app_aead_replay_check(sender, epoch, counter)) {
+        s_app_aead_stats.frames_rejected++;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t start = esp_timer_get_time();
+    size_t plain_len = len - APP_AEAD_OVERHEAD;
+    if(mbedtls_gcm_auth_decrypt(&s_app_aead_open_ctx, plain_len, in, APP_AEAD_NONCE_LEN, NULL, 0,
+                                &in[APP_AEAD_NONCE_LEN + plain_len], APP_AEAD_TAG_LEN, &in[APP_AEAD_NONCE_LEN], out) != 0) {
+        s_app_aead_stats.frames_rejected++;
+        return ESP_FAIL;
+    }
+    *out_len = plain_len;
+
+    s_app_aead_stats.frames_opened++;
+    app_aead_replay_update(id, sender, epoch, counter);
+    s_app_aead_stats.bytes += plain_len;
+    s_app_aead_stats.time_us += (uint32_t)(esp_timer_get_time() - start);
+    return ESP_OK;
+}
+
+/**
+ * @brief encryption statistics for telemetry
+ *
+ * @param stats filled with counters
+ */
+void app_aead_stats_get(app_aead_stats_t *stats)
+{
+    memcpy(stats, &s_app_aead_stats, sizeof(*stats));
+}
+
+/** @} */ // End of app_aead_global_funcs group
+
+/** @} */ // End of app_aead module
@@ -0,0 +1,133 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_aead.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application link frame encryption header
+ */
+
+#ifndef APP_AEAD_H
+#define APP_AEAD_H
+
+/**
+ * @defgroup app_aead Application link frame encryption Module
+ * @brief Module for authenticated encryption of link frames with AES-GCM
+ * @{
+ */
+
+/**
+ * @addtogroup app_aead_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+/** @} */ // End of app_aead_include group
+
+/**
+ * @addtogroup app_aead_define
+ * @{
+ */
+
+#define APP_AEAD_KEY_LEN        16
+
+/* nonce is sender id, key epoch and frame counter, sent in clear ahead of ciphertext */
+#define APP_AEAD_NONCE_LEN      12
+#define APP_AEAD_TAG_LEN        12
+#define APP_AEAD_OVERHEAD       (APP_AEAD_NONCE_LEN + APP_AEAD_TAG_LEN)
+
+/* senders tracked for replay protection, least recently heard sender is forgotten when full */
+#define APP_AEAD_SENDER_MAX     32
+
+/* frames a sender may arrive out of order and still be accepted */
+#define APP_AEAD_REPLAY_WINDOW  32
+
+/** @} */ // End of app_aead_define group
+
+/**
+ * @addtogroup app_aead_types
+ * @{
+ */
+
+/* encryption statistics reported in telemetry, counters wrap */
+typedef struct {
+    uint32_t frames_sealed;     /**< frames encrypted */
+    uint32_t frames_opened;     /**< frames decrypted and authenticated */
+    uint32_t frames_rejected;   /**< frames failing authentication or replay check */
+    uint32_t bytes;             /**< plaintext bytes encrypted and decrypted */
+    uint32_t time_us;           /**< time spent encrypting and decrypting in microseconds */
+} app_aead_stats_t;
+
+/** @} */ // End of app_aead_types group
+
+/**
+ * @addtogroup app_aead_global_funcs
+ * @{
+ */
+
+/**
+ * @brief loads link key and starts a new key epoch, NVS storage handle must be open
+ *
+ * @return esp error code
+ */
+esp_err_t app_aead_init(void);
+
+/**
+ * @brief encrypts and authenticates one link frame
+ *
+ * @param in frame bytes
+ * @param len length of frame
+ * @param out buffer for sealed frame, at least len + APP_AEAD_OVERHEAD bytes
+ * @param out_size size of out buffer
+ * @param out_len length of sealed frame
+ * @return esp error code
+ */
+esp_err_t app_aead_seal(const uint8_t *in, size_t len, uint8_t *out, size_t out_size, size_t *out_len);
+
+/**
+ * @brief authenticates and decrypts one sealed link frame, rejecting replayed frames
+ *
+ * @param in sealed frame bytes
+ * @param len length of sealed frame
+ * @param out buffer for frame, at least len - APP_AEAD_OVERHEAD bytes
+ * @param out_len length of frame
+ * @return esp error code
+ */
+esp_err_t app_aead_open(const uint8_t *in, size_t len, uint8_t *out, size_t *out_len);
+
+/**
+ * @brief encryption statistics for telemetry
+ *
+ * @param stats filled with counters
+ */
+void app_aead_stats_get(app_aead_stats_t *stats);
+
+/** @} */ // End of app_aead_global_funcs group
+
+/** @} */ // End of app_aead group
+
+#endif
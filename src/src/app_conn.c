@@ -52,7 +52,7 @@
 #include "app_tusb.h"
 #include "led.h"
 #include "button.h"
-#include "app_espnow.h"
+#include "app_link.h"
 #include "app_conn.h"
 #include "app_conn.h"
 
@@ -146,7 +146,9 @@ static void app_conn_task(void *params)
             {
                 int button_press_time = 0;
 
-                app_espnow_device_conn_send(device_conn);
+                for(uint8_t session = 0; session < app_link_session_count_get(); session++) {
+                    app_link_device_conn_send(session, device_conn);
+                }
                 app_conn_on(device_conn.conn_on_period, device_conn.conn_off_period, device_conn.conn_on_count);
                 while(button_read() == BUTTON_GPIO_PRESSED)
                 {
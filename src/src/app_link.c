@@ -0,0 +1,2083 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_link.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application link protocol module which communicates with peer devices over selected transport
+ */
+
+/**
+ * @defgroup app_link Application link protocol Module
+ * @brief Module for managing framing, sequencing and acknowledgement of peer communication over a selectable transport
+ * @{
+ */
+
+/**
+ * @addtogroup app_link_include
+ * @{
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <string.h>
+#include <assert.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "esp_mac.h"
+#include "esp_crc.h"
+#include "config.h"
+#include "nvs_peer.h"
+#include "commons.h"
+#include "led.h"
+#include "app_tusb.h"
+#include "app_uart.h"
+#include "app_conn.h"
+#include "app_link.h"
+#include "app_espnow.h"
+#include "app_udp.h"
+#include "app_tsync.h"
+#include "app_tdma.h"
+#include "app_txpwr.h"
+#include "app_aead.h"
+#include "app_relay.h"
+
+/** @} */ // End of app_link_include group
+
+/**
+ * @addtogroup app_link_define
+ * @{
+ */
+
+
+#define APP_LINK_BROADCAST_ENABLE CONFIG_ESPNOW_BROADCAST_ENABLE
+
+// 0 for default peer mac, 1 for peer mac from NVS memory
+#if APP_LINK_BROADCAST_ENABLE
+#define APP_LINK_USE_NVS_PEER_MAC    0
+#else
+#if CONFIG_ESPNOW_USE_NVS_PEER_MAC
+#define APP_LINK_USE_NVS_PEER_MAC    1
+#else
+#define APP_LINK_USE_NVS_PEER_MAC    0
+#endif
+#endif
+
+#if DEVICE_WISER_RELAY && APP_LINK_BROADCAST_ENABLE
+#error Relay forwards between two paired peers and does not support broadcast mode!
+#endif
+#if (APP_LINK_SESSION_COUNT > 1) && APP_LINK_BROADCAST_ENABLE
+#error Peers are told apart by MAC address, broadcast mode supports a single peer!
+#endif
+#if (APP_LINK_SESSION_COUNT > 1) && (CONFIG_LINK_TRANSPORT == LINK_TRANSPORT_UDP)
+#error UDP transport reaches a single peer, use ESP-NOW transport for more than one peer!
+#endif
+/* each peer holds a retransmit stream and a transmit task, more do not fit in RAM next to Wi-Fi and TinyUSB */
+#define APP_LINK_SESSION_COUNT_MAX      4
+#if APP_LINK_SESSION_COUNT > APP_LINK_SESSION_COUNT_MAX
+#error Each peer takes about 11 KB of RAM, CONFIG_LINK_PEER_COUNT must be at most 4!
+#endif
+
+/* WiSer-UART switches to a standby WiSer-USB when the active one goes silent */
+#if CONFIG_LINK_FAILOVER_ENABLE && DEVICE_WISER_UART
+#define APP_LINK_FAILOVER_ENABLE      1
+#else
+#define APP_LINK_FAILOVER_ENABLE      0
+#endif
+#if APP_LINK_FAILOVER_ENABLE && (APP_LINK_BROADCAST_ENABLE || (CONFIG_LINK_TRANSPORT == LINK_TRANSPORT_UDP))
+#error Failover tells both WiSer-USB apart by MAC address over ESP-NOW, broadcast mode and UDP transport are not supported!
+#endif
+
+#define APP_LINK_TX_SER_COUNT_DEFAULT 1
+
+#define APP_LINK_SEND_RETRY_COUNT     3
+
+/* data payload used until peer capabilities are known, a sealed frame still fits ESP-NOW v1 */
+#if CONFIG_LINK_AEAD_ENABLE
+#define APP_LINK_DATA_SIZE_MIN        (APP_LINK_SEND_DATA_SIZE - APP_AEAD_OVERHEAD)
+#else
+#define APP_LINK_DATA_SIZE_MIN        APP_LINK_SEND_DATA_SIZE
+#endif
+
+/* wrap safe comparison of stream byte offsets */
+#define APP_LINK_OFFSET_DIFF(a, b)    ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+
+#define APP_LINK_SEND_TIMEOUT_DEFAULT 20  // in ms
+
+/* longest wait of received config settings for the data sent before them, in case that data was dropped */
+#define APP_LINK_CONFIG_WAIT_MS       1000
+
+/* data frames sent per chunk size adaptation step */
+#define APP_LINK_CHUNK_WINDOW           32
+/* frame loss in percent above which chunk size is halved, below which it grows by a quarter */
+#define APP_LINK_CHUNK_LOSS_HIGH        10
+#define APP_LINK_CHUNK_LOSS_LOW         2
+
+/* class without frames for this long no longer takes part in airtime arbitration */
+#define APP_LINK_SCHED_ACTIVE_MS        10
+/* virtual time resolution, airtime bytes are scaled by this and divided by class weight */
+#define APP_LINK_SCHED_SCALE            64
+/* period of per class throughput measurement */
+#define APP_LINK_SCHED_RATE_MS          1000
+
+/* data directions seen from this device */
+#if DEVICE_WISER_USB
+#define APP_LINK_SCHED_WEIGHT_DATA_TX   CONFIG_LINK_SCHED_WEIGHT_H2T
+#define APP_LINK_SCHED_WEIGHT_DATA_RX   CONFIG_LINK_SCHED_WEIGHT_T2H
+#else
+#define APP_LINK_SCHED_WEIGHT_DATA_TX   CONFIG_LINK_SCHED_WEIGHT_T2H
+#define APP_LINK_SCHED_WEIGHT_DATA_RX   CONFIG_LINK_SCHED_WEIGHT_H2T
+#endif
+
+/** @} */ // End of app_link_define group
+
+/**
+ * @addtogroup app_link_static_vars
+ * @{
+ */
+
+/**
+ * @brief Tag used for logging in this module
+ */
+static const char *TAG = "app_link";
+
+/**
+ * @brief queue handler
+ */
+static QueueHandle_t s_app_link_queue;
+static SemaphoreHandle_t xSemaphoreLinkSend = NULL;
+/* scheduler state is updated from tasks and the receive callback, never held across blocking calls */
+static portMUX_TYPE s_app_link_sched_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static app_link_session_t s_app_link_sessions[APP_LINK_SESSION_COUNT];
+
+/* largest data payload of the local transport */
+static size_t s_app_link_local_mtu = APP_LINK_DATA_SIZE_MIN;
+
+static app_link_sched_class_t s_app_link_sched[APP_LINK_SCHED_CLASS_COUNT] = {
+    [APP_LINK_SCHED_DATA_TX] = { .weight = APP_LINK_SCHED_WEIGHT_DATA_TX },
+    [APP_LINK_SCHED_DATA_RX] = { .weight = APP_LINK_SCHED_WEIGHT_DATA_RX },
+    [APP_LINK_SCHED_CTRL] = { .weight = CONFIG_LINK_SCHED_WEIGHT_CTRL },
+    [APP_LINK_SCHED_ACK] = { .weight = CONFIG_LINK_SCHED_WEIGHT_ACK },
+};
+static TickType_t s_app_link_sched_rate_tick = 0;
+
+/**
+ * @brief default peer mac address
+ */
+#if APP_LINK_USE_NVS_PEER_MAC
+static const uint8_t s_app_peer_mac_default[APP_LINK_ETH_ALEN] = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+#else
+static const uint8_t s_app_peer_mac_default[APP_LINK_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+#endif
+
+/* operating channel of the pair */
+static uint8_t s_app_link_channel = CONFIG_LINK_CHANNEL;
+static const uint8_t s_app_link_channel_list[] = CONFIG_LINK_CHANNEL_LIST;
+
+/**
+ * @brief transport carrying link frames
+ */
+#if (CONFIG_LINK_TRANSPORT == LINK_TRANSPORT_UDP)
+static const app_link_transport_t *s_app_link_transport = &app_udp_transport;
+#else
+static const app_link_transport_t *s_app_link_transport = &app_espnow_transport;
+#endif
+
+#if CONFIG_LINK_AEAD_ENABLE
+/* sealed frame being sent, guarded by send lock */
+static uint8_t s_app_link_aead_tx_buf[APP_LINK_FRAME_LEN_MAX];
+/* opened frame being received, transports receive in a single context */
+static uint8_t s_app_link_aead_rx_buf[APP_LINK_FRAME_LEN_MAX];
+#endif
+
+/** @} */ // End of app_link_static_vars group
+
+/**
+ * @addtogroup app_link_global_vars
+ * @{
+ */
+
+// Define any global variables here
+
+/** @} */ // End of app_link_global_vars group
+
+/**
+ * @addtogroup app_link_static_funcs
+ * @{
+ */
+
+/**
+ * @brief task which handles frames received from peers
+ *
+ * @param pvParameter task parameters
+ */
+static void app_link_task(void *pvParameter);
+
+/**
+ * @brief task which sends queued stream data to peer and retransmits unacknowledged bytes
+ *
+ * @param pvParameter link session of peer
+ */
+static void app_link_tx_task(void *pvParameter);
+
+/**
+ * @brief finds link session of a peer
+ *
+ * @param mac_addr peer mac address
+ * @return link session, NULL if sender is not a peer
+ */
+static app_link_session_t *app_link_session_find(const uint8_t *mac_addr);
+
+/**
+ * @brief index of a link session
+ *
+ * @param s link session
+ * @return session index
+ */
+static uint8_t app_link_session_index(const app_link_session_t *s);
+
+/**
+ * @brief builds data frame from stream bytes starting at oldest unacknowledged offset
+ *
+ * @param s link session
+ * @param frame frame buffer of at least APP_LINK_DATA_HEADER_LEN + APP_LINK_SEND_DATA_SIZE_MAX bytes
+ * @param flags data frame flags
+ * @return total length of frame
+ */
+static size_t app_link_data_frame_build(app_link_session_t *s, uint8_t *frame, uint8_t flags);
+
+/**
+ * @brief delivers received data frame by stream offset, dropping bytes already delivered
+ *
+ * @param recv_cb received data frame
+ * @return false if there was no room for the bytes and frame was not taken
+ */
+static bool app_link_data_received(const app_link_event_recv_cb_t *recv_cb);
+
+/**
+ * @brief handles config settings frame received from peer, holding settings until data sent before them is delivered
+ *
+ * @param recv_cb received config settings frame
+ */
+static void app_link_config_settings_received(const app_link_event_recv_cb_t *recv_cb);
+
+/**
+ * @brief applies pending config settings once data sent before them is delivered or wait has expired
+ *
+ * @param s link session
+ */
+static void app_link_config_pending_apply(app_link_session_t *s);
+
+/**
+ * @brief sends acknowledgement of stream bytes received up to offset
+ *
+ * @param s link session
+ * @param offset next expected stream byte offset
+ * @param flags APP_LINK_DATA_ACK_FLAG_* bits
+ */
+static void app_link_data_offset_ack_send(app_link_session_t *s, uint32_t offset, uint8_t flags);
+
+/**
+ * @brief finds largest data payload supported by the local transport
+ *
+ * @return data payload size in bytes
+ */
+static size_t app_link_local_mtu_get(void);
+
+/**
+ * @brief largest data frame payload allowed by negotiated mtu and configured chunk bounds
+ *
+ * @param s link session
+ * @return data payload size in bytes
+ */
+static size_t app_link_chunk_max_get(const app_link_session_t *s);
+
+/**
+ * @brief shrinks data frame payload on high frame loss and grows it back on a clean channel
+ *
+ * @param s link session
+ * @param sent data frames sent in last window
+ * @param lost data frames not acknowledged in last window
+ */
+static void app_link_chunk_adapt(app_link_session_t *s, uint32_t sent, uint32_t lost);
+
+/**
+ * @brief charges airtime of a frame to its scheduler class
+ *
+ * @param id scheduler class
+ * @param len frame length in bytes
+ */
+static void app_link_sched_charge(app_link_sched_id_t id, size_t len);
+
+/**
+ * @brief rolls per class and per session throughput measurement when its period has elapsed
+ *
+ */
+static void app_link_sched_rate_update(void);
+
+/**
+ * @brief checks if a class is behind every other active class in weighted airtime
+ *
+ * @param id scheduler class
+ * @return true if class may use the channel now
+ */
+static bool app_link_sched_eligible(app_link_sched_id_t id);
+
+/**
+ * @brief sends one frame to peer under the send lock and charges it to its scheduler class
+ *
+ * @param s link session
+ * @param id scheduler class of frame
+ * @param data frame bytes
+ * @param len length of frame
+ * @return  esp error code
+ */
+static esp_err_t app_link_frame_send(app_link_session_t *s, app_link_sched_id_t id, const uint8_t *data, size_t len);
+
+/**
+ * @brief sends one frame to peer like app_link_frame_send, letting a callback update it once the send lock is held
+ *
+ * @param s link session
+ * @param id scheduler class of frame
+ * @param data frame bytes, updated by presend
+ * @param len length of frame
+ * @param presend called right before frame is sealed and sent, NULL for none
+ * @return  esp error code
+ */
+static esp_err_t app_link_frame_send_hooked(app_link_session_t *s, app_link_sched_id_t id, uint8_t *data, size_t len, app_link_presend_cb_t presend);
+
+/**
+ * @brief stamps transmit time into time sync frame, t1 of requests or t3 of responses
+ *
+ * @param data time sync frame
+ * @param len length of frame
+ */
+static void app_link_time_sync_stamp(uint8_t *data, size_t len);
+
+/**
+ * @brief sends local link capabilities to peer
+ *
+ * @param s link session
+ * @param reply_req 1 to request peer capabilities in reply
+ */
+static void app_link_caps_send(app_link_session_t *s, uint8_t reply_req);
+
+/**
+ * @brief applies link capabilities received from peer
+ *
+ * @param s link session
+ * @param link_caps peer link capabilities
+ */
+static void app_link_caps_received(app_link_session_t *s, const link_caps_t link_caps);
+
+/**
+ * @brief handles sending acknowledgement on new ser packet received from peer
+ *
+ * @param s link session
+ * @param type data packet type
+ * @param ser_count serial count of data packet
+ */
+static void app_link_ser_count_received(app_link_session_t *s, uint8_t type, uint8_t ser_count) ;
+
+/**
+ * @brief derives operating channel from MAC addresses of both devices of the pair
+ *
+ * @param peer_mac peer mac address
+ * @return channel
+ */
+static uint8_t app_link_channel_derive(const uint8_t *peer_mac);
+
+/**
+ * @brief initialize module tasks for communication between peers
+ *
+ * @return  esp error code
+ */
+static esp_err_t app_link_tasks_init(void);
+
+/**
+ * @brief resets the serial packet counts
+ *
+ * @param s link session
+ */
+static void app_link_ser_count_reset(app_link_session_t *s);
+
+/**
+ * @brief decides whether an unacknowledged data frame is kept for a standby peer, failing over once active peer is silent
+ *
+ * @param s link session
+ * @return true if frame is kept and retransmitted, false if it may be dropped
+ */
+static bool app_link_failover_hold(app_link_session_t *s);
+
+/**
+ * @brief makes standby peer of a session the active one, unacknowledged data is replayed to it from the tx stream
+ *
+ * @param s link session
+ */
+static void app_link_failover(app_link_session_t *s);
+
+/**
+ * @brief send acknowledgement for last packet received from peer
+ *
+ * @param s link session
+ * @param  data_ack data acknowledgement packet
+ */
+static void app_link_data_ack_send(app_link_session_t *s, const data_ack_t data_ack);
+
+/**
+ * @brief sends control frame to peer and waits for acknowledgement
+ *
+ * @param s link session
+ * @param type frame type
+ * @param payload frame payload, NULL if frame has no payload
+ * @param len length of payload
+ */
+static void app_link_ctrl_send(app_link_session_t *s, uint8_t type, const void *payload, size_t len);
+
+/**
+ * @brief sends data packet to peer
+ *
+ * @param s link session
+ * @param  data data packet bytes
+ * @param len length of data bytes
+ */
+static void app_link_send(app_link_session_t *s, uint8_t *data, size_t len);
+
+/** @} */ // End of app_link_static_funcs group
+
+/**
+ * @addtogroup app_link_static_funcs
+ * @{
+ */
+/**
+ * @brief task which handles frames received from peers
+ *
+ * @param pvParameter task parameters
+ */
+static void IRAM_ATTR app_link_task(void *pvParameter)
+{
+    app_link_event_t evt;
+
+    vTaskDelay(1000);
+    ESP_LOGI(TAG, "Start link task");
+
+    while (true) {
+        TickType_t wait = portMAX_DELAY;
+        for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+            app_link_session_t *s = &s_app_link_sessions[i];
+            if(s->config_pending_valid) {
+                TickType_t waited = xTaskGetTickCount() - s->config_pending_tick;
+                TickType_t left = (waited < pdMS_TO_TICKS(APP_LINK_CONFIG_WAIT_MS)) ? (pdMS_TO_TICKS(APP_LINK_CONFIG_WAIT_MS) - waited) : 0;
+                if(left < wait) {
+                    wait = left;
+                }
+            }
+        }
+        if(xQueueReceive(s_app_link_queue, &evt, wait) != pdTRUE) {
+            for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+                app_link_config_pending_apply(&s_app_link_sessions[i]);
+            }
+            continue;
+        }
+        switch (evt.id) {
+            case APP_LINK_TRANSPORT_UP:
+            {
+                ESP_LOGE(TAG, "%s transport up", s_app_link_transport->name);
+                for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+                    app_link_caps_send(&s_app_link_sessions[i], 1);
+                }
+#if DEVICE_WISER_UART
+                app_link_config_req_send(APP_LINK_SESSION_DEFAULT);
+#elif DEVICE_WISER_RELAY
+                app_link_config_req_send(APP_RELAY_SESSION_UPSTREAM);
+#endif
+                break;
+            }
+            case APP_LINK_FAILOVER:
+            {
+                // line settings stay as they are, new peer only needs to agree on frame size
+                app_link_caps_send(&s_app_link_sessions[evt.info.failover.session], 1);
+                break;
+            }
+            case APP_LINK_RECV_CB:
+            {
+                app_link_event_recv_cb_t *recv_cb = &evt.info.recv_cb;
+                app_link_session_t *s = &s_app_link_sessions[recv_cb->session];
+
+                // ESP_LOGI(TAG, "Receive error data from: "MACSTR"", MAC2STR(recv_cb->mac_addr));
+                switch(recv_cb->type) {
+                    case APP_LINK_TYPE_DATA: {
+                        #if DEVICE_WISER_USB
+                            led_rx_on();
+                        #endif
+#if DEVICE_WISER_USB
+                        app_link_data_received(recv_cb);
+#else
+                        // a frame without room is refused instead of waited on, so this task keeps serving both peers
+                        if(app_link_data_received(recv_cb)) {
+                            app_link_data_offset_ack_send(s, recv_cb->offset + recv_cb->data_len, 0);
+                        } else {
+                            app_link_data_offset_ack_send(s, s->rx.nxt, APP_LINK_DATA_ACK_FLAG_BUSY);
+                        }
+#endif
+                        app_link_config_pending_apply(s);
+                        #if DEVICE_WISER_USB
+                            led_rx_off();
+                        #endif
+                    } break;
+                    case APP_LINK_TYPE_CONFIG_SETTINGS: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        app_link_config_settings_received(recv_cb);
+                    } break;
+                    case APP_LINK_TYPE_CONFIG_HW_LINE: {
+                        config_hw_line_t config_hw_line;
+                        memcpy(&config_hw_line, &recv_cb->data[0], sizeof(config_hw_line));
+                        // ESP_LOGI(TAG, "Receive dtr: %d rts: %d", config_hw_line.dtr, config_hw_line.rts);
+                        #if DEVICE_WISER_UART
+                            app_uart_dtr_set(config_hw_line.dtr);
+                            app_uart_rts_set(config_hw_line.rts);
+                        #endif
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        #if DEVICE_WISER_RELAY
+                            app_relay_config_hw_line_received(recv_cb->session, config_hw_line);
+                        #endif
+                    } break;
+                    case APP_LINK_TYPE_DEVICE_CONN: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        device_conn_t device_conn;
+                        memcpy(&device_conn, &recv_cb->data[0], sizeof(device_conn));
+                        // ESP_LOGI(TAG, "Receive conn from: period: %d", device_conn.conn_on_period);
+                        app_conn_on(device_conn.conn_on_period, device_conn.conn_off_period, device_conn.conn_on_count);
+                        #if DEVICE_WISER_RELAY
+                            app_relay_device_conn_received(recv_cb->session, device_conn);
+                        #endif
+                    } break;
+                    case APP_LINK_TYPE_CONFIG_REQ: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        #if DEVICE_WISER_USB
+                            app_tusb_config_request(recv_cb->session);
+                        #elif DEVICE_WISER_RELAY
+                            app_relay_config_req_received(recv_cb->session);
+                        #endif
+                    } break;
+                    case APP_LINK_TYPE_TIME_SYNC: {
+                        // requests are answered on every session, responses only update the clock of the default peer
+                        time_sync_t time_sync;
+                        if(recv_cb->data_len >= sizeof(time_sync)) {
+                            memcpy(&time_sync, &recv_cb->data[0], sizeof(time_sync));
+                            app_tsync_received(recv_cb->session, time_sync, recv_cb->rx_time);
+                        }
+                    } break;
+                    case APP_LINK_TYPE_FLOW_CTRL: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        flow_ctrl_t flow_ctrl;
+                        if(recv_cb->data_len >= sizeof(flow_ctrl)) {
+                            memcpy(&flow_ctrl, &recv_cb->data[0], sizeof(flow_ctrl));
+                            #if DEVICE_WISER_USB
+                                app_tusb_flow_ctrl_received(recv_cb->session, flow_ctrl);
+                            #elif DEVICE_WISER_RELAY
+                                app_relay_flow_ctrl_received(recv_cb->session, flow_ctrl);
+                            #endif
+                        }
+                    } break;
+                    case APP_LINK_TYPE_SERIAL_STATE: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        serial_state_t serial_state;
+                        if(recv_cb->data_len >= sizeof(serial_state)) {
+                            memcpy(&serial_state, &recv_cb->data[0], sizeof(serial_state));
+                            #if DEVICE_WISER_USB
+                                app_tusb_serial_state_received(recv_cb->session, serial_state);
+                            #elif DEVICE_WISER_RELAY
+                                app_relay_serial_state_received(recv_cb->session, serial_state);
+                            #endif
+                        }
+                    } break;
+                    case APP_LINK_TYPE_AUTOBAUD: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        autobaud_t autobaud;
+                        if(recv_cb->data_len >= sizeof(autobaud)) {
+                            memcpy(&autobaud, &recv_cb->data[0], sizeof(autobaud));
+                            #if DEVICE_WISER_USB
+                                app_tusb_autobaud_received(recv_cb->session, autobaud);
+                            #elif DEVICE_WISER_RELAY
+                                app_relay_autobaud_received(recv_cb->session, autobaud);
+                            #endif
+                        }
+                    } break;
+                    case APP_LINK_TYPE_TDMA_ASSIGN: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        tdma_assign_t tdma_assign;
+                        if(recv_cb->session == APP_LINK_SESSION_DEFAULT && recv_cb->data_len >= sizeof(tdma_assign)) {
+                            memcpy(&tdma_assign, &recv_cb->data[0], sizeof(tdma_assign));
+                            app_tdma_assign_received(tdma_assign);
+                        }
+                    } break;
+                    case APP_LINK_TYPE_LINK_REPORT: {
+                        link_report_t link_report;
+                        if(recv_cb->data_len >= sizeof(link_report)) {
+                            memcpy(&link_report, &recv_cb->data[0], sizeof(link_report));
+                            app_txpwr_report_received(recv_cb->session, link_report);
+                        }
+                    } break;
+                    case APP_LINK_TYPE_LINK_CAPS: {
+                        app_link_ser_count_received(s, recv_cb->type, recv_cb->ser_count);
+                        link_caps_t link_caps;
+                        if(recv_cb->data_len >= sizeof(link_caps)) {
+                            memcpy(&link_caps, &recv_cb->data[0], sizeof(link_caps));
+                            app_link_caps_received(s, link_caps);
+                        }
+                    } break;
+                    default: {
+                    } break;
+                }
+                vPortFree(recv_cb->data);
+                break;
+            }
+            default:
+                ESP_LOGE(TAG, "Callback type error: %d", evt.id);
+                break;
+        }
+        taskYIELD();
+    }
+}
+
+/**
+ * @brief finds link session of a peer
+ *
+ * @param mac_addr peer mac address
+ * @return link session, NULL if sender is not a peer
+ */
+static app_link_session_t *IRAM_ATTR app_link_session_find(const uint8_t *mac_addr)
+{
+#if APP_LINK_BROADCAST_ENABLE
+    // every sender is a peer in broadcast mode
+    return &s_app_link_sessions[0];
+#else
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        if(memcmp(mac_addr, s_app_link_sessions[i].peer_mac, APP_LINK_ETH_ALEN) == 0) {
+            return &s_app_link_sessions[i];
+        }
+#if APP_LINK_FAILOVER_ENABLE
+        if(s_app_link_sessions[i].standby_valid && memcmp(mac_addr, s_app_link_sessions[i].standby_mac, APP_LINK_ETH_ALEN) == 0) {
+            return &s_app_link_sessions[i];
+        }
+#endif
+    }
+    return NULL;
+#endif
+}
+
+/**
+ * @brief index of a link session
+ *
+ * @param s link session
+ * @return session index
+ */
+static uint8_t app_link_session_index(const app_link_session_t *s)
+{
+    return (uint8_t)(s - &s_app_link_sessions[0]);
+}
+
+/**
+ * @brief decides whether an unacknowledged data frame is kept for a standby peer, failing over once active peer is silent
+ *
+ * @param s link session
+ * @return true if frame is kept and retransmitted, false if it may be dropped
+ */
+static bool app_link_failover_hold(app_link_session_t *s)
+{
+#if APP_LINK_FAILOVER_ENABLE
+    if(!s->standby_valid) {
+        return false;
+    }
+    // both the frame and the peer must be stale, a peer quiet while idle is not yet lost
+    int64_t now = esp_timer_get_time();
+    if((now - s->last_rx_time) >= CONFIG_LINK_FAILOVER_MS * 1000LL && (now - s->unacked_since) >= CONFIG_LINK_FAILOVER_MS * 1000LL) {
+        app_link_failover(s);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief makes standby peer of a session the active one, unacknowledged data is replayed to it from the tx stream
+ *
+ * @param s link session
+ */
+static void app_link_failover(app_link_session_t *s)
+{
+    uint8_t mac[APP_LINK_ETH_ALEN];
+    app_link_event_t evt;
+
+    // no frame is in the middle of being sent to the old peer while addresses swap
+    xSemaphoreTake(xSemaphoreLinkSend, portMAX_DELAY);
+    memcpy(mac, s->peer_mac, APP_LINK_ETH_ALEN);
+    memcpy(s->peer_mac, s->standby_mac, APP_LINK_ETH_ALEN);
+    memcpy(s->standby_mac, mac, APP_LINK_ETH_ALEN);
+    xSemaphoreGive(xSemaphoreLinkSend);
+
+    // new peer syncs its receive stream to the oldest unacknowledged byte, which is sent next
+    s->tx.syn = true;
+    s->rx.synced = false;
+    memset(s->config_last, 0, sizeof(s->config_last));
+    s->config_pending_valid = false;
+    s->mtu = APP_LINK_DATA_SIZE_MIN;
+    s->chunk = app_link_chunk_max_get(s);
+    s->rssi = 0;
+    s->last_rx_time = esp_timer_get_time();
+    s->unacked_since = s->last_rx_time;
+    s->stats.failovers++;
+    ESP_LOGE(TAG, "failover to %02x:%02x:%02x:%02x:%02x:%02x, replaying %lu bytes", s->peer_mac[0], s->peer_mac[1], s->peer_mac[2],
+            s->peer_mac[3], s->peer_mac[4], s->peer_mac[5], (unsigned long)(s->tx.nxt - s->tx.una));
+
+    evt.id = APP_LINK_FAILOVER;
+    evt.info.failover.session = app_link_session_index(s);
+    if(xQueueSend(s_app_link_queue, &evt, 0) != pdTRUE) {
+        ESP_LOGE(TAG, "Send failover queue fail");
+    }
+}
+
+/**
+ * @brief handles sending acknowledgement on new ser packet received from peer
+ *
+ * @param s link session
+ * @param type data packet type
+ * @param ser_count serial count of data packet
+ */
+static void IRAM_ATTR app_link_ser_count_received(app_link_session_t *s, uint8_t type, uint8_t ser_count)
+{
+    if(type != APP_LINK_TYPE_ACK) {
+        data_ack_t data_ack;
+        memset(&data_ack, 0, sizeof(data_ack));
+        data_ack.type = type;
+        data_ack.ser_count = ser_count;
+        app_link_data_ack_send(s, data_ack);
+    }
+}
+
+/**
+ * @brief delivers received data frame by stream offset, dropping bytes already delivered
+ *
+ * @param recv_cb received data frame
+ * @return false if there was no room for the bytes and frame was not taken
+ */
+static bool IRAM_ATTR app_link_data_received(const app_link_event_recv_cb_t *recv_cb)
+{
+    app_link_rx_stream_t *rx = &s_app_link_sessions[recv_cb->session].rx;
+    uint32_t end = recv_cb->offset + recv_cb->data_len;
+    size_t skip = 0;
+
+    // peer started a new stream, sync to its initial offset
+    if(!rx->synced || ((recv_cb->ser_count & APP_LINK_DATA_FLAG_SYN) && recv_cb->offset != rx->isn)) {
+        rx->synced = true;
+        rx->isn = recv_cb->offset;
+        rx->nxt = recv_cb->offset;
+    }
+
+    if(APP_LINK_OFFSET_DIFF(end, rx->nxt) <= 0) {
+        // retransmission of bytes already delivered
+        return true;
+    }
+
+    if(APP_LINK_OFFSET_DIFF(recv_cb->offset, rx->nxt) < 0) {
+        skip = rx->nxt - recv_cb->offset;
+    } else if(recv_cb->offset != rx->nxt) {
+        ESP_LOGE(TAG, "stream gap: %lu bytes", (unsigned long)(recv_cb->offset - rx->nxt));
+    }
+
+#if DEVICE_WISER_USB
+    app_tusb_write(recv_cb->session, &recv_cb->data[skip], recv_cb->data_len - skip);
+#elif DEVICE_WISER_UART
+    if(app_uart_tx_space_get() < recv_cb->data_len - skip) {
+        return false;
+    }
+    app_uart_write(&recv_cb->data[skip], recv_cb->data_len - skip);
+#elif DEVICE_WISER_RELAY
+    if(!app_relay_data_received(recv_cb->session, &recv_cb->data[skip], recv_cb->data_len - skip)) {
+        return false;
+    }
+#endif
+    rx->nxt = end;
+    return true;
+}
+
+/**
+ * @brief handles config settings frame received from peer, holding settings until data sent before them is delivered
+ *
+ * @param recv_cb received config settings frame
+ */
+static void app_link_config_settings_received(const app_link_event_recv_cb_t *recv_cb)
+{
+    app_link_session_t *s = &s_app_link_sessions[recv_cb->session];
+    uint8_t frame[sizeof(s->config_last)];
+    size_t len = recv_cb->data_len;
+
+    // older peers send settings without fields appended since, those read 0
+    if(len < offsetof(config_settings_t, sw_flow_status)) {
+        return;
+    }
+    if(len > sizeof(config_settings_t)) {
+        len = sizeof(config_settings_t);
+    }
+    // a retransmission after a lost ack carries the same serial count and settings
+    memset(frame, 0, sizeof(frame));
+    frame[0] = recv_cb->type;
+    frame[1] = recv_cb->ser_count;
+    memcpy(&frame[APP_LINK_HEADER_LEN], recv_cb->data, len);
+    if(memcmp(frame, s->config_last, sizeof(frame)) == 0) {
+        return;
+    }
+    memcpy(s->config_last, frame, sizeof(frame));
+
+    // settings not yet applied are superseded, their data boundary is behind the new one
+    memcpy(&s->config_pending, &frame[APP_LINK_HEADER_LEN], sizeof(config_settings_t));
+    s->config_pending_valid = true;
+    s->config_pending_tick = xTaskGetTickCount();
+    app_link_config_pending_apply(s);
+}
+
+/**
+ * @brief applies pending config settings once data sent before them is delivered or wait has expired
+ *
+ * @param s link session
+ */
+static void app_link_config_pending_apply(app_link_session_t *s)
+{
+    const config_settings_t *config = &s->config_pending;
+    app_link_rx_stream_t *rx = &s->rx;
+    bool delivered = false;
+
+    if(!s->config_pending_valid) {
+        return;
+    }
+    if(config->stream_offset == config->stream_isn) {
+        // peer sent no data before the settings
+        delivered = true;
+    } else if(rx->synced) {
+        // peer keeps at most a stream buffer of unacknowledged bytes, a larger distance is another stream
+        int32_t remaining = APP_LINK_OFFSET_DIFF(config->stream_offset, rx->nxt);
+        delivered = (remaining <= 0) || (remaining > APP_LINK_TX_STREAM_SIZE);
+    }
+    if(!delivered) {
+        if((xTaskGetTickCount() - s->config_pending_tick) < pdMS_TO_TICKS(APP_LINK_CONFIG_WAIT_MS)) {
+            return;
+        }
+        ESP_LOGE(TAG, "config applied before data boundary");
+    }
+    s->config_pending_valid = false;
+#if DEVICE_WISER_UART
+    app_uart_config_reset(*config);
+#elif DEVICE_WISER_RELAY
+    app_relay_config_settings_received(app_link_session_index(s), *config);
+#endif
+}
+
+/**
+ * @brief sends acknowledgement of stream bytes received up to offset
+ *
+ * @param s link session
+ * @param offset next expected stream byte offset
+ */
+static void IRAM_ATTR app_link_data_offset_ack_send(app_link_session_t *s, uint32_t offset, uint8_t flags)
+{
+    data_ack_t data_ack;
+
+    memset(&data_ack, 0, sizeof(data_ack));
+    data_ack.type = APP_LINK_TYPE_DATA;
+    data_ack.ser_count = flags;
+    data_ack.offset = offset;
+    app_link_data_ack_send(s, data_ack);
+}
+
+/**
+ * @brief finds largest data payload supported by the local transport
+ *
+ * @return data payload size in bytes
+ */
+static size_t app_link_local_mtu_get(void)
+{
+    size_t frame_len_max = s_app_link_transport->frame_len_max_get();
+
+    if(frame_len_max > APP_LINK_FRAME_LEN_MAX) {
+        frame_len_max = APP_LINK_FRAME_LEN_MAX;
+    }
+#if CONFIG_LINK_AEAD_ENABLE
+    frame_len_max -= APP_AEAD_OVERHEAD;
+#endif
+    if(frame_len_max < APP_LINK_DATA_HEADER_LEN + APP_LINK_DATA_SIZE_MIN) {
+        return APP_LINK_DATA_SIZE_MIN;
+    }
+    return frame_len_max - APP_LINK_DATA_HEADER_LEN;
+}
+
+/**
+ * @brief charges airtime of a frame to its scheduler class
+ *
+ * @param id scheduler class
+ * @param len frame length in bytes
+ */
+static void IRAM_ATTR app_link_sched_charge(app_link_sched_id_t id, size_t len)
+{
+    app_link_sched_class_t *cls = &s_app_link_sched[id];
+    TickType_t now = xTaskGetTickCount();
+    bool found = false;
+    uint32_t vmin = 0;
+
+    // receive callback charges here too, so it must not block
+    portENTER_CRITICAL(&s_app_link_sched_lock);
+    // class waking up from idle starts level with active classes instead of spending saved credit
+    if((now - cls->last_tick) > pdMS_TO_TICKS(APP_LINK_SCHED_ACTIVE_MS)) {
+        for(int i = 0; i < APP_LINK_SCHED_CLASS_COUNT; i++) {
+            app_link_sched_class_t *other = &s_app_link_sched[i];
+            if(i == id || (now - other->last_tick) > pdMS_TO_TICKS(APP_LINK_SCHED_ACTIVE_MS)) {
+                continue;
+            }
+            if(!found || APP_LINK_OFFSET_DIFF(other->vtime, vmin) < 0) {
+                vmin = other->vtime;
+                found = true;
+            }
+        }
+        if(found) {
+            cls->vtime = vmin;
+        }
+    }
+    cls->vtime += (uint32_t)((len * APP_LINK_SCHED_SCALE) / cls->weight);
+    cls->last_tick = now;
+    cls->bytes += len;
+    portEXIT_CRITICAL(&s_app_link_sched_lock);
+}
+
+/**
+ * @brief rolls per class and per session throughput measurement when its period has elapsed
+ *
+ */
+static void app_link_sched_rate_update(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    TickType_t elapsed = now - s_app_link_sched_rate_tick;
+
+    if(elapsed < pdMS_TO_TICKS(APP_LINK_SCHED_RATE_MS)) {
+        return;
+    }
+    portENTER_CRITICAL(&s_app_link_sched_lock);
+    for(int i = 0; i < APP_LINK_SCHED_CLASS_COUNT; i++) {
+        s_app_link_sched[i].rate = (uint32_t)(((uint64_t)s_app_link_sched[i].bytes * 1000) / pdTICKS_TO_MS(elapsed));
+        s_app_link_sched[i].bytes = 0;
+    }
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        app_link_session_t *s = &s_app_link_sessions[i];
+        s->stats.tx_rate = (uint32_t)(((uint64_t)s->tx_bytes * 1000) / pdTICKS_TO_MS(elapsed));
+        s->stats.rx_rate = (uint32_t)(((uint64_t)s->rx_bytes * 1000) / pdTICKS_TO_MS(elapsed));
+        s->tx_bytes = 0;
+        s->rx_bytes = 0;
+    }
+    s_app_link_sched_rate_tick = now;
+    portEXIT_CRITICAL(&s_app_link_sched_lock);
+}
+
+/**
+ * @brief checks if a class is behind every other active class in weighted airtime
+ *
+ * @param id scheduler class
+ * @return true if class may use the channel now
+ */
+static bool IRAM_ATTR app_link_sched_eligible(app_link_sched_id_t id)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t vtime = s_app_link_sched[id].vtime;
+
+    for(int i = 0; i < APP_LINK_SCHED_CLASS_COUNT; i++) {
+        app_link_sched_class_t *other = &s_app_link_sched[i];
+        bool active = other->pending || (now - other->last_tick) <= pdMS_TO_TICKS(APP_LINK_SCHED_ACTIVE_MS);
+        if(i != id && active && APP_LINK_OFFSET_DIFF(other->vtime, vtime) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief sends one frame to peer under the send lock and charges it to its scheduler class
+ *
+ * @param s link session
+ * @param id scheduler class of frame
+ * @param data frame bytes
+ * @param len length of frame
+ * @return  esp error code
+ */
+static esp_err_t IRAM_ATTR app_link_frame_send(app_link_session_t *s, app_link_sched_id_t id, const uint8_t *data, size_t len)
+{
+    // frame is only read without a callback
+    return app_link_frame_send_hooked(s, id, (uint8_t *)data, len, NULL);
+}
+
+/**
+ * @brief sends one frame to peer like app_link_frame_send, letting a callback update it once the send lock is held
+ *
+ * @param s link session
+ * @param id scheduler class of frame
+ * @param data frame bytes, updated by presend
+ * @param len length of frame
+ * @param presend called right before frame is sealed and sent, NULL for none
+ * @return  esp error code
+ */
+static esp_err_t IRAM_ATTR app_link_frame_send_hooked(app_link_session_t *s, app_link_sched_id_t id, uint8_t *data, size_t len, app_link_presend_cb_t presend)
+{
+    esp_err_t err = ESP_FAIL;
+
+    // waiting control frames and acks hold back data until they are sent, counted by several tasks at once
+    portENTER_CRITICAL(&s_app_link_sched_lock);
+    s_app_link_sched[id].pending++;
+    portEXIT_CRITICAL(&s_app_link_sched_lock);
+    if(xSemaphoreTake(xSemaphoreLinkSend, portMAX_DELAY) == pdTRUE) {
+        // time spent waiting for the lock behind other frames is not part of what is stamped
+        if(presend != NULL) {
+            presend(data, len);
+        }
+#if CONFIG_LINK_AEAD_ENABLE
+        size_t sealed_len = 0;
+        err = app_aead_seal(data, len, s_app_link_aead_tx_buf, sizeof(s_app_link_aead_tx_buf), &sealed_len);
+        if(err == ESP_OK) {
+            err = s_app_link_transport->send(s->peer_mac, s_app_link_aead_tx_buf, sealed_len);
+        }
+#else
+        err = s_app_link_transport->send(s->peer_mac, data, len);
+#endif
+        xSemaphoreGive(xSemaphoreLinkSend);
+    }
+    portENTER_CRITICAL(&s_app_link_sched_lock);
+    s_app_link_sched[id].pending--;
+    portEXIT_CRITICAL(&s_app_link_sched_lock);
+    if(err == ESP_OK) {
+        app_link_sched_charge(id, len);
+    }
+    return err;
+}
+
+/**
+ * @brief largest data frame payload allowed by negotiated mtu and configured chunk bounds
+ *
+ * @param s link session
+ * @return data payload size in bytes
+ */
+static size_t app_link_chunk_max_get(const app_link_session_t *s)
+{
+    size_t chunk_max = s->mtu;
+
+    if(chunk_max > CONFIG_LINK_CHUNK_SIZE_MAX) {
+        chunk_max = CONFIG_LINK_CHUNK_SIZE_MAX;
+    }
+    if(chunk_max < CONFIG_LINK_CHUNK_SIZE_MIN) {
+        chunk_max = CONFIG_LINK_CHUNK_SIZE_MIN;
+    }
+    return chunk_max;
+}
+
+/**
+ * @brief shrinks data frame payload on high frame loss and grows it back on a clean channel
+ *
+ * @param s link session
+ * @param sent data frames sent in last window
+ * @param lost data frames not acknowledged in last window
+ */
+static void app_link_chunk_adapt(app_link_session_t *s, uint32_t sent, uint32_t lost)
+{
+    size_t chunk_max = app_link_chunk_max_get(s);
+    size_t chunk = s->chunk;
+    uint32_t loss = (lost * 100) / sent;
+
+    // short frames are less likely to be hit by interference and cheaper to retransmit
+    if(loss > APP_LINK_CHUNK_LOSS_HIGH) {
+        chunk = chunk / 2;
+    } else if(loss < APP_LINK_CHUNK_LOSS_LOW) {
+        chunk = chunk + (chunk / 4) + 1;
+    }
+    if(chunk > chunk_max) {
+        chunk = chunk_max;
+    }
+    if(chunk < CONFIG_LINK_CHUNK_SIZE_MIN) {
+        chunk = CONFIG_LINK_CHUNK_SIZE_MIN;
+    }
+    s->stats.loss = loss;
+    if(chunk != s->chunk) {
+        s->chunk = chunk;
+        ESP_LOGE(TAG, "session %u loss: %lu%%, chunk: %u", app_link_session_index(s), (unsigned long)loss, (unsigned int)chunk);
+    }
+}
+
+/**
+ * @brief sends local link capabilities to peer
+ *
+ * @param s link session
+ * @param reply_req 1 to request peer capabilities in reply
+ */
+static void app_link_caps_send(app_link_session_t *s, uint8_t reply_req)
+{
+    link_caps_t link_caps;
+
+    memset(&link_caps, 0, sizeof(link_caps));
+    link_caps.reply_req = reply_req;
+    link_caps.max_data_size = s_app_link_local_mtu;
+#if DEVICE_WISER_RELAY
+    // this relay and those behind the peer on the other side, 1 until that side reports
+    const app_link_session_t *other = &s_app_link_sessions[(app_link_session_index(s) == APP_RELAY_SESSION_UPSTREAM) ? APP_RELAY_SESSION_DOWNSTREAM : APP_RELAY_SESSION_UPSTREAM];
+    link_caps.hops = other->peer_hops + 1;
+#endif
+
+    app_link_ctrl_send(s, APP_LINK_TYPE_LINK_CAPS, &link_caps, sizeof(link_caps));
+}
+
+/**
+ * @brief applies link capabilities received from peer
+ *
+ * @param s link session
+ * @param link_caps peer link capabilities
+ */
+static void app_link_caps_received(app_link_session_t *s, const link_caps_t link_caps)
+{
+    size_t mtu = s_app_link_local_mtu;
+
+    // peers without capability support never answer and stay at the v1 size
+    if(link_caps.max_data_size < mtu) {
+        mtu = link_caps.max_data_size;
+    }
+    if(mtu < APP_LINK_DATA_SIZE_MIN) {
+        mtu = APP_LINK_DATA_SIZE_MIN;
+    }
+    if(mtu != s->mtu) {
+        s->mtu = mtu;
+        s->chunk = app_link_chunk_max_get(s);
+        ESP_LOGE(TAG, "session %u link mtu: %u", app_link_session_index(s), (unsigned int)mtu);
+        if(s->bitrate != 0) {
+            app_link_send_timeout_update(app_link_session_index(s), s->bitrate);
+        }
+    }
+
+    if(link_caps.reply_req) {
+        app_link_caps_send(s, 0);
+    }
+
+    if(link_caps.hops != s->peer_hops) {
+        s->peer_hops = link_caps.hops;
+        ESP_LOGE(TAG, "session %u hops: %u", app_link_session_index(s), (unsigned int)(s->peer_hops + 1));
+#if DEVICE_WISER_RELAY
+        // pass the path length on towards the far end
+        app_link_caps_send(&s_app_link_sessions[(app_link_session_index(s) == APP_RELAY_SESSION_UPSTREAM) ? APP_RELAY_SESSION_DOWNSTREAM : APP_RELAY_SESSION_UPSTREAM], 0);
+#endif
+    }
+}
+
+/**
+ * @brief derives operating channel from MAC addresses of both devices of the pair
+ *
+ * @param peer_mac peer mac address
+ * @return channel
+ */
+static uint8_t app_link_channel_derive(const uint8_t *peer_mac)
+{
+    uint8_t own_mac[APP_LINK_ETH_ALEN];
+
+    esp_read_mac(own_mac, ESP_MAC_WIFI_STA);
+    return app_link_channel_pair_derive(own_mac, peer_mac);
+}
+
+/**
+ * @brief initialize module tasks for communication between peers
+ *
+ * @return  esp error code
+ */
+static esp_err_t app_link_tasks_init(void)
+{
+    xSemaphoreLinkSend = xSemaphoreCreateBinary();
+    xSemaphoreGive(xSemaphoreLinkSend);
+
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        app_link_session_t *s = &s_app_link_sessions[i];
+
+        s->ack = xSemaphoreCreateBinary();
+        s->data_ack = xSemaphoreCreateBinary();
+        s->tx_data = xSemaphoreCreateBinary();
+        s->tx_space = xSemaphoreCreateBinary();
+        s->tx_stream = xSemaphoreCreateMutex();
+        s->ctrl_send = xSemaphoreCreateMutex();
+
+        // start stream at random offset so peer can tell a restarted stream from a retransmission
+        s->tx.una = esp_random();
+        s->tx.nxt = s->tx.una;
+        s->tx.isn = s->tx.una;
+        s->tx.syn = true;
+        s->mtu = APP_LINK_DATA_SIZE_MIN;
+        s->chunk = APP_LINK_DATA_SIZE_MIN;
+        s->send_timeout = APP_LINK_SEND_TIMEOUT_DEFAULT;
+        app_link_ser_count_reset(s);
+    }
+
+#if DEVICE_WISER_USB || DEVICE_WISER_RELAY
+    s_app_link_queue = xQueueCreate(60, sizeof(app_link_event_t));
+#else
+    s_app_link_queue = xQueueCreate(9, sizeof(app_link_event_t));
+#endif
+    if (s_app_link_queue == NULL) {
+        ESP_LOGE(TAG, "Create s_app_link_queue fail");
+        return ESP_FAIL;
+    }
+
+    xTaskCreate(app_link_task, "app_link_task", 2048, NULL, 3, NULL);
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        xTaskCreate(app_link_tx_task, "app_link_tx_task", 2048, &s_app_link_sessions[i], 3, NULL);
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief resets the serial packet counts
+ *
+ * @param s link session
+ */
+static void app_link_ser_count_reset(app_link_session_t *s) {
+    s->tx_ser_count = APP_LINK_TX_SER_COUNT_DEFAULT;
+    s->rx.synced = false;
+}
+
+/**
+ * @brief send acknowledgement for last packet received from peer
+ *
+ * @param s link session
+ * @param  data_ack data acknowledgement packet
+ */
+static void app_link_data_ack_send(app_link_session_t *s, const data_ack_t data_ack)
+{
+    uint8_t data_tosend[APP_LINK_HEADER_LEN + sizeof(data_ack_t)];
+
+    // prepare data
+    data_tosend[0] = APP_LINK_TYPE_ACK;
+    data_tosend[1] = 0;
+    memcpy(&data_tosend[2], &data_ack, sizeof(data_ack));
+
+    if (app_link_frame_send(s, APP_LINK_SCHED_ACK, data_tosend, sizeof(data_tosend)) != ESP_OK) {
+        ESP_LOGE(TAG, "Send ack error");
+    }
+}
+
+/**
+ * @brief sends control frame to peer and waits for acknowledgement
+ *
+ * @param s link session
+ * @param type frame type
+ * @param payload frame payload, NULL if frame has no payload
+ * @param len length of payload
+ */
+static void app_link_ctrl_send(app_link_session_t *s, uint8_t type, const void *payload, size_t len)
+{
+    uint8_t *data_tosend = (uint8_t *)pvPortMalloc(len+2);
+    size_t len_tosend = len+2;
+
+    if(data_tosend == NULL) {
+        ESP_LOGE(TAG, "Malloc send data fail");
+        return;
+    }
+    // prepare data
+    data_tosend[0] = type;
+    if(len != 0) {
+        memcpy(&data_tosend[2], payload, len);
+    }
+
+    // control senders of several tasks share the ack slot of the session, an ack only matches its own frame
+    xSemaphoreTake(s->ctrl_send, portMAX_DELAY);
+    data_tosend[1] = s->tx_ser_count++;
+    app_link_send(s, data_tosend, len_tosend);
+    xSemaphoreGive(s->ctrl_send);
+    vPortFree(data_tosend);
+}
+
+/**
+ * @brief sends data packet to peer
+ *
+ * @param s link session
+ * @param  data data packet bytes
+ * @param len length of data bytes
+ */
+static void app_link_send(app_link_session_t *s, uint8_t *data, size_t len) {
+    uint8_t retry_count = APP_LINK_SEND_RETRY_COUNT;
+    if(len >= 2 && data[0] != APP_LINK_TYPE_ACK) {
+        // late ack of an earlier frame must not end the wait for this one
+        xSemaphoreTake(s->ack, 0);
+        s->send_status = false;
+        s->last_ack.type = data[0];
+        s->last_ack.ser_count = data[1];
+
+        do {
+            if (app_link_frame_send(s, APP_LINK_SCHED_CTRL, data, len) != ESP_OK) {
+                ESP_LOGE(TAG, "Send error");
+            } else {
+                xSemaphoreTake(s->ack, s->send_timeout);
+            }
+            retry_count--;
+            if(s->send_status != true) {
+                ESP_LOGE(TAG, "retry");
+            }
+            taskYIELD();
+        } while(s->send_status == false && retry_count > 0);
+    }
+}
+
+/**
+ * @brief builds data frame from stream bytes starting at oldest unacknowledged offset
+ *
+ * @param s link session
+ * @param frame frame buffer of at least APP_LINK_DATA_HEADER_LEN + APP_LINK_SEND_DATA_SIZE_MAX bytes
+ * @param flags data frame flags
+ * @return total length of frame
+ */
+static size_t IRAM_ATTR app_link_data_frame_build(app_link_session_t *s, uint8_t *frame, uint8_t flags)
+{
+    app_link_tx_stream_t *tx = &s->tx;
+    uint32_t offset = tx->una;
+    size_t len = tx->nxt - offset;
+    size_t pos = offset & (APP_LINK_TX_STREAM_SIZE - 1);
+    size_t chunk = s->chunk;
+    size_t first = 0;
+
+    // lost bytes are merged with bytes queued since, up to a full frame
+    if(len > chunk) {
+        len = chunk;
+    }
+    first = APP_LINK_TX_STREAM_SIZE - pos;
+    if(first > len) {
+        first = len;
+    }
+
+    frame[0] = APP_LINK_TYPE_DATA;
+    frame[1] = flags;
+    memcpy(&frame[APP_LINK_HEADER_LEN], &offset, sizeof(offset));
+    memcpy(&frame[APP_LINK_DATA_HEADER_LEN], &tx->buf[pos], first);
+    memcpy(&frame[APP_LINK_DATA_HEADER_LEN + first], &tx->buf[0], len - first);
+
+    return APP_LINK_DATA_HEADER_LEN + len;
+}
+
+/**
+ * @brief task which sends queued stream data to peer and retransmits unacknowledged bytes
+ *
+ * @param pvParameter link session of peer
+ */
+static void IRAM_ATTR app_link_tx_task(void *pvParameter)
+{
+    app_link_session_t *s = (app_link_session_t *)pvParameter;
+    uint8_t *frame = s->frame;
+    app_link_tx_stream_t *tx = &s->tx;
+    uint8_t retry_count = 0;
+    uint32_t window_sent = 0;
+    uint32_t window_lost = 0;
+
+    while (true) {
+        if(tx->una == tx->nxt) {
+            xSemaphoreTake(s->tx_data, portMAX_DELAY);
+            continue;
+        }
+
+        if(app_tdma_is_active()) {
+            // slots already separate the directions, only wait for own slot
+            app_tdma_tx_wait();
+        } else if(!app_link_sched_eligible(APP_LINK_SCHED_DATA_TX)) {
+            // leave the channel to peer data, control frames and acks that are behind in weighted airtime
+            vTaskDelay(1);
+            continue;
+        }
+
+        uint8_t flags = (tx->syn ? APP_LINK_DATA_FLAG_SYN : 0) | (retry_count ? APP_LINK_DATA_FLAG_RETX : 0);
+        size_t len = app_link_data_frame_build(s, frame, flags);
+        bool acked = false;
+        bool busy = false;
+
+#if DEVICE_WISER_USB
+        led_tx_on();
+#endif
+        // discard ack left over from an earlier frame
+        xSemaphoreTake(s->data_ack, 0);
+        esp_err_t err = app_link_frame_send(s, APP_LINK_SCHED_DATA_TX, frame, len);
+#if DEVICE_WISER_USB
+        led_tx_off();
+#endif
+        if(err != ESP_OK) {
+            ESP_LOGE(TAG, "Send error");
+        } else {
+            s->tx_bytes += len;
+            if(xSemaphoreTake(s->data_ack, s->send_timeout) == pdTRUE) {
+                uint32_t ack = s->last_data_ack_offset;
+                busy = s->last_data_ack_busy;
+                acked = APP_LINK_OFFSET_DIFF(ack, tx->una) > 0 && APP_LINK_OFFSET_DIFF(ack, tx->nxt) <= 0;
+                if(acked) {
+                    s->stats.bytes_acked += (uint32_t)(ack - tx->una);
+                    tx->una = ack;
+                    tx->syn = false;
+                }
+            }
+        }
+
+        s->stats.frames_sent++;
+        if(retry_count) {
+            s->stats.frames_retx++;
+        }
+        if(busy && !acked) {
+            // peer is there but has no room yet, neither a loss for chunk size nor a retry towards dropping
+            s->stats.frames_busy++;
+            vTaskDelay(s->send_timeout);
+            continue;
+        }
+        window_sent++;
+        if(!acked) {
+            window_lost++;
+        }
+        if(window_sent >= APP_LINK_CHUNK_WINDOW) {
+            app_link_chunk_adapt(s, window_sent, window_lost);
+            window_sent = 0;
+            window_lost = 0;
+        }
+
+        if(!acked && retry_count == 0) {
+            s->unacked_since = esp_timer_get_time();
+        }
+        if(acked) {
+            retry_count = 0;
+            xSemaphoreGive(s->tx_space);
+        } else if(++retry_count >= APP_LINK_SEND_RETRY_COUNT && app_link_failover_hold(s)) {
+            // kept for whichever peer acknowledges it, a gap in the stream is worse than a delay
+            retry_count = APP_LINK_SEND_RETRY_COUNT;
+        } else if(retry_count >= APP_LINK_SEND_RETRY_COUNT) {
+            // give up on this frame, peer resyncs on next offset
+            ESP_LOGE(TAG, "drop %u bytes", (unsigned int)(len - APP_LINK_DATA_HEADER_LEN));
+            tx->una = tx->una + (len - APP_LINK_DATA_HEADER_LEN);
+            s->stats.frames_dropped++;
+            retry_count = 0;
+            xSemaphoreGive(s->tx_space);
+        } else {
+            ESP_LOGE(TAG, "retry");
+        }
+        taskYIELD();
+    }
+}
+
+/**
+ * @brief stamps transmit time into time sync frame, t1 of requests or t3 of responses
+ *
+ * @param data time sync frame
+ * @param len length of frame
+ */
+static void IRAM_ATTR app_link_time_sync_stamp(uint8_t *data, size_t len)
+{
+    uint8_t *payload = &data[APP_LINK_HEADER_LEN];
+    int64_t now = esp_timer_get_time();
+
+    if(len < APP_LINK_HEADER_LEN + sizeof(time_sync_t)) {
+        return;
+    }
+    // AEAD sealing after this takes about as long on both devices, so it mostly cancels out of the offset
+    if(payload[offsetof(time_sync_t, reply)]) {
+        memcpy(&payload[offsetof(time_sync_t, t3)], &now, sizeof(now));
+    } else {
+        memcpy(&payload[offsetof(time_sync_t, t1)], &now, sizeof(now));
+    }
+}
+
+/** @} */ // End of app_link_static_funcs group
+
+/**
+ * @addtogroup app_link_global_funcs
+ * @{
+ */
+
+/**
+ * @brief number of link sessions, one per peer
+ *
+ * @return session count
+ */
+uint8_t app_link_session_count_get(void)
+{
+    return APP_LINK_SESSION_COUNT;
+}
+
+/**
+ * @brief queues serial data to be sent to peer, blocks while retransmit buffer is full
+ *
+ * @param session link session of peer
+ * @param  data data packet bytes
+ * @param len length of data bytes
+ */
+void app_link_data_send(uint8_t session, const uint8_t *data, size_t len)
+{
+    app_link_session_t *s = &s_app_link_sessions[session];
+    app_link_tx_stream_t *tx = &s->tx;
+    size_t tx_len = 0;
+
+    xSemaphoreTake(s->tx_stream, portMAX_DELAY);
+    while(len != tx_len) {
+        size_t space = APP_LINK_TX_STREAM_SIZE - (tx->nxt - tx->una);
+        if(space == 0) {
+            xSemaphoreTake(s->tx_space, portMAX_DELAY);
+            continue;
+        }
+
+        size_t pos = tx->nxt & (APP_LINK_TX_STREAM_SIZE - 1);
+        size_t chunk = len - tx_len;
+        if(chunk > space) {
+            chunk = space;
+        }
+        if(chunk > APP_LINK_TX_STREAM_SIZE - pos) {
+            chunk = APP_LINK_TX_STREAM_SIZE - pos;
+        }
+        memcpy(&tx->buf[pos], &data[tx_len], chunk);
+        tx->nxt = tx->nxt + chunk;
+        tx_len = tx_len + chunk;
+        xSemaphoreGive(s->tx_data);
+    }
+    xSemaphoreGive(s->tx_stream);
+}
+
+/**
+ * @brief free space of retransmit buffer, app_link_data_send of up to this many bytes does not block
+ *
+ * @param session link session of peer
+ * @return free space in bytes
+ */
+size_t app_link_tx_space_get(uint8_t session)
+{
+    const app_link_tx_stream_t *tx = &s_app_link_sessions[session].tx;
+
+    return APP_LINK_TX_STREAM_SIZE - (tx->nxt - tx->una);
+}
+
+/**
+ * @brief sends serial config settings to peer, applied by peer after all data queued before this call
+ * @param session link session of peer
+ * @param config_settings config settings to be sent
+ */
+void app_link_config_settings_send(uint8_t session, const config_settings_t config_settings)
+{
+    app_link_session_t *s = &s_app_link_sessions[session];
+    config_settings_t settings = config_settings;
+
+    // mark the switch point in the data stream
+    xSemaphoreTake(s->tx_stream, portMAX_DELAY);
+    settings.stream_isn = s->tx.isn;
+    settings.stream_offset = s->tx.nxt;
+    xSemaphoreGive(s->tx_stream);
+
+    app_link_ctrl_send(s, APP_LINK_TYPE_CONFIG_SETTINGS, &settings, sizeof(settings));
+}
+
+/**
+ * @brief sends serial hw line state to peer
+ * @param session link session of peer
+ * @param config_hw_line config hw line state to be sent
+ */
+void app_link_config_hw_line_send(uint8_t session, const config_hw_line_t config_hw_line)
+{
+    app_link_ctrl_send(&s_app_link_sessions[session], APP_LINK_TYPE_CONFIG_HW_LINE, &config_hw_line, sizeof(config_hw_line));
+}
+
+/**
+ * @brief sends connection indication event to peer
+ * @param session link session of peer
+ * @param device_conn connection indication parameters
+ */
+void app_link_device_conn_send(uint8_t session, const device_conn_t device_conn)
+{
+    app_link_ctrl_send(&s_app_link_sessions[session], APP_LINK_TYPE_DEVICE_CONN, &device_conn, sizeof(device_conn));
+}
+
+/**
+ * @brief sends XON/XOFF state of target to peer
+ * @param session link session of peer
+ * @param flow_ctrl XON/XOFF state
+ */
+void app_link_flow_ctrl_send(uint8_t session, const flow_ctrl_t flow_ctrl)
+{
+    app_link_ctrl_send(&s_app_link_sessions[session], APP_LINK_TYPE_FLOW_CTRL, &flow_ctrl, sizeof(flow_ctrl));
+}
+
+/**
+ * @brief sends UART errors and line state of target to peer
+ * @param session link session of peer
+ * @param serial_state UART errors and line state
+ */
+void app_link_serial_state_send(uint8_t session, const serial_state_t serial_state)
+{
+    app_link_ctrl_send(&s_app_link_sessions[session], APP_LINK_TYPE_SERIAL_STATE, &serial_state, sizeof(serial_state));
+}
+
+/**
+ * @brief sends bitrate of target detected by auto-baud to peer
+ * @param session link session of peer
+ * @param autobaud detected bitrate
+ */
+void app_link_autobaud_send(uint8_t session, const autobaud_t autobaud)
+{
+    app_link_ctrl_send(&s_app_link_sessions[session], APP_LINK_TYPE_AUTOBAUD, &autobaud, sizeof(autobaud));
+}
+
+/**
+ * @brief sends serial configuration request to peer
+ * @param session link session of peer
+ */
+void app_link_config_req_send(uint8_t session)
+{
+    app_link_ctrl_send(&s_app_link_sessions[session], APP_LINK_TYPE_CONFIG_REQ, NULL, 0);
+}
+
+/**
+ * @brief data payload size negotiated with peer
+ *
+ * @param session link session of peer
+ * @return data payload size in bytes
+ */
+size_t app_link_mtu_get(uint8_t session)
+{
+    return s_app_link_sessions[session].mtu;
+}
+
+/**
+ * @brief link statistics of one hop for telemetry
+ *
+ * @param session link session of peer
+ * @param stats filled with counters and current frame sizes
+ */
+void app_link_stats_get(uint8_t session, app_link_stats_t *stats)
+{
+    app_link_session_t *s = &s_app_link_sessions[session];
+
+    app_link_sched_rate_update();
+    memcpy(stats, &s->stats, sizeof(*stats));
+    stats->mtu = s->mtu;
+    stats->chunk = s->chunk;
+    stats->rssi = app_link_rssi_get(session);
+    stats->tx_power = app_txpwr_get();
+    stats->hops = app_link_hops_get(session);
+#if CONFIG_LINK_AEAD_ENABLE
+    app_aead_stats_t aead_stats;
+    app_aead_stats_get(&aead_stats);
+    stats->crypto_bytes = aead_stats.bytes;
+    stats->crypto_time_us = aead_stats.time_us;
+    stats->crypto_rejected = aead_stats.frames_rejected;
+#endif
+}
+
+/**
+ * @brief updates ack wait timeout for the serial bit rate and current data payload size
+ *
+ * @param session link session of peer
+ * @param bitrate serial bit rate
+ */
+void app_link_send_timeout_update(uint8_t session, uint32_t bitrate)
+{
+    app_link_session_t *s = &s_app_link_sessions[session];
+
+    if(bitrate == 0) {
+        return;
+    }
+    s->bitrate = bitrate;
+    s->send_timeout = (uint32_t)((s->mtu*8*1000)/bitrate) + (uint32_t)(1000/bitrate) + 20;
+    ESP_LOGE(TAG, "app_link_send_timeout: %lu", s->send_timeout);
+}
+
+/**
+ * @brief initialize module link protocol for communication between peers
+ *
+ */
+void app_link_init(void)
+{
+    uint8_t channel = 0;
+
+    // Initialize NVS
+    nvs_peer_init();
+    nvs_peer_open();
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        memcpy(s_app_link_sessions[i].peer_mac, s_app_peer_mac_default, APP_LINK_ETH_ALEN);
+    }
+#if APP_LINK_USE_NVS_PEER_MAC
+    nvs_peer_read(s_app_link_sessions[APP_LINK_SESSION_DEFAULT].peer_mac);
+#if DEVICE_WISER_USB
+    for(int i = 1; i < APP_LINK_SESSION_COUNT; i++) {
+        if(!nvs_peer_table_read(i, s_app_link_sessions[i].peer_mac)) {
+            ESP_LOGE(TAG, "peer %d missing from peer table", i);
+        }
+    }
+#endif
+#if DEVICE_WISER_RELAY
+    nvs_peer_relay_read(s_app_link_sessions[APP_RELAY_SESSION_DOWNSTREAM].peer_mac);
+#endif
+#if APP_LINK_FAILOVER_ENABLE
+    s_app_link_sessions[APP_LINK_SESSION_DEFAULT].standby_valid = nvs_peer_standby_read(s_app_link_sessions[APP_LINK_SESSION_DEFAULT].standby_mac);
+#endif
+#endif
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        const uint8_t *mac = s_app_link_sessions[i].peer_mac;
+        ESP_LOGE(TAG, "peer %d mac address - %02x:%02x:%02x:%02x:%02x:%02x", i, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        if(s_app_link_sessions[i].standby_valid) {
+            mac = s_app_link_sessions[i].standby_mac;
+            ESP_LOGE(TAG, "peer %d standby mac address - %02x:%02x:%02x:%02x:%02x:%02x", i, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        }
+    }
+
+    // broadcast devices have no pair identity to agree on, devices with several peers or a standby peer need one channel for all
+    if(nvs_peer_channel_read(&channel) && channel >= 1 && channel <= 13) {
+        s_app_link_channel = channel;
+    } else if(CONFIG_LINK_CHANNEL_AUTO_ENABLE && !APP_LINK_BROADCAST_ENABLE && APP_LINK_SESSION_COUNT == 1
+            && !s_app_link_sessions[APP_LINK_SESSION_DEFAULT].standby_valid) {
+        s_app_link_channel = app_link_channel_derive(s_app_link_sessions[APP_LINK_SESSION_DEFAULT].peer_mac);
+    }
+#if CONFIG_LINK_AEAD_ENABLE
+    ESP_ERROR_CHECK( app_aead_init() );
+#endif
+    nvs_peer_close();
+    ESP_LOGE(TAG, "channel: %u", s_app_link_channel);
+
+    app_link_tasks_init();
+
+    ESP_ERROR_CHECK( s_app_link_transport->init() );
+    s_app_link_local_mtu = app_link_local_mtu_get();
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        s_app_link_sessions[i].chunk = app_link_chunk_max_get(&s_app_link_sessions[i]);
+    }
+    ESP_LOGE(TAG, "transport: %s, local mtu: %u", s_app_link_transport->name, (unsigned)s_app_link_local_mtu);
+}
+
+/**
+ * @brief deinitialize module link protocol
+ *
+ */
+void app_link_deinit(void)
+{
+    for(int i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+        app_link_session_t *s = &s_app_link_sessions[i];
+        vSemaphoreDelete(s->ack);
+        vSemaphoreDelete(s->data_ack);
+        vSemaphoreDelete(s->tx_data);
+        vSemaphoreDelete(s->tx_space);
+        vSemaphoreDelete(s->tx_stream);
+        vSemaphoreDelete(s->ctrl_send);
+    }
+    vSemaphoreDelete(xSemaphoreLinkSend);
+    vQueueDelete(s_app_link_queue);
+}
+
+/**
+ * @brief sends time sync frame to peer without acknowledgement, stamping transmit time
+ *
+ * @param session link session of peer
+ * @param time_sync time sync frame, t1 of requests or t3 of responses is set to transmit time
+ */
+void app_link_time_sync_send(uint8_t session, time_sync_t *time_sync)
+{
+    uint8_t data_tosend[APP_LINK_HEADER_LEN + sizeof(time_sync_t)];
+
+    // a lost exchange is replaced by the next one, retrying would only add stale timestamps
+    data_tosend[0] = APP_LINK_TYPE_TIME_SYNC;
+    data_tosend[1] = 0;
+    memcpy(&data_tosend[APP_LINK_HEADER_LEN], time_sync, sizeof(time_sync_t));
+    app_link_frame_send_hooked(&s_app_link_sessions[session], APP_LINK_SCHED_CTRL, data_tosend, sizeof(data_tosend),
+                               app_link_time_sync_stamp);
+    memcpy(time_sync, &data_tosend[APP_LINK_HEADER_LEN], sizeof(time_sync_t));
+}
+
+/**
+ * @brief sends TDMA slot assignment to peer
+ * @param session link session of peer
+ * @param tdma_assign slot assignment
+ */
+void app_link_tdma_assign_send(uint8_t session, const tdma_assign_t tdma_assign)
+{
+    app_link_ctrl_send(&s_app_link_sessions[session], APP_LINK_TYPE_TDMA_ASSIGN, &tdma_assign, sizeof(tdma_assign));
+}
+
+/**
+ * @brief sends link report to peer without acknowledgement
+ * @param session link session of peer
+ * @param link_report local view of the link
+ */
+void app_link_report_send(uint8_t session, const link_report_t link_report)
+{
+    uint8_t data_tosend[APP_LINK_HEADER_LEN + sizeof(link_report_t)];
+
+    // prepare data, reports are periodic so a lost one is not retried
+    data_tosend[0] = APP_LINK_TYPE_LINK_REPORT;
+    data_tosend[1] = 0;
+    memcpy(&data_tosend[APP_LINK_HEADER_LEN], &link_report, sizeof(link_report));
+
+    app_link_frame_send(&s_app_link_sessions[session], APP_LINK_SCHED_CTRL, data_tosend, sizeof(data_tosend));
+}
+
+/**
+ * @brief average RSSI of frames received from peer
+ *
+ * @param session link session of peer
+ * @return RSSI in dBm, 0 if transport does not provide it
+ */
+int8_t app_link_rssi_get(uint8_t session)
+{
+    return (int8_t)(s_app_link_sessions[session].rssi / 16);
+}
+
+/**
+ * @brief radio hops to the far end device, learned from capabilities relayed along the path
+ *
+ * @param session link session of peer
+ * @return hop count, 1 for a direct link
+ */
+uint8_t app_link_hops_get(uint8_t session)
+{
+    return s_app_link_sessions[session].peer_hops + 1;
+}
+
+/**
+ * @brief sets transmit power of transport
+ *
+ * @param power transmit power in units of 0.25 dBm
+ */
+void app_link_tx_power_set(int8_t power)
+{
+    s_app_link_transport->tx_power_set(power);
+}
+
+/**
+ * @brief transmit power of transport
+ *
+ * @return transmit power in units of 0.25 dBm
+ */
+int8_t app_link_tx_power_get(void)
+{
+    return s_app_link_transport->tx_power_get();
+}
+
+/**
+ * @brief Wi-Fi TSF of transport if it is shared with peer
+ *
+ * @return TSF in microseconds, 0 if transport has no shared TSF
+ */
+int64_t app_link_tsf_get(void)
+{
+    if(s_app_link_transport->tsf_get == NULL) {
+        return 0;
+    }
+    return s_app_link_transport->tsf_get();
+}
+
+/**
+ * @brief operating channel of the pair, from NVS override, derived from pair MAC addresses or default
+ *
+ * @return channel
+ */
+uint8_t app_link_channel_get(void)
+{
+    return s_app_link_channel;
+}
+
+/**
+ * @brief derives operating channel of a pair from MAC addresses of both its devices, same for either order
+ *
+ * @param mac_a mac address of one device
+ * @param mac_b mac address of other device
+ * @return channel
+ */
+uint8_t app_link_channel_pair_derive(const uint8_t *mac_a, const uint8_t *mac_b)
+{
+    uint8_t pair[2 * APP_LINK_ETH_ALEN];
+
+    // order MAC addresses so both devices hash the same pair identity
+    if(memcmp(mac_a, mac_b, APP_LINK_ETH_ALEN) < 0) {
+        memcpy(&pair[0], mac_a, APP_LINK_ETH_ALEN);
+        memcpy(&pair[APP_LINK_ETH_ALEN], mac_b, APP_LINK_ETH_ALEN);
+    } else {
+        memcpy(&pair[0], mac_b, APP_LINK_ETH_ALEN);
+        memcpy(&pair[APP_LINK_ETH_ALEN], mac_a, APP_LINK_ETH_ALEN);
+    }
+
+    uint32_t hash = esp_crc32_le(0, pair, sizeof(pair));
+    return s_app_link_channel_list[hash % sizeof(s_app_link_channel_list)];
+}
+
+/**
+ * @brief peer mac address of a link session
+ *
+ * @param session link session of peer
+ * @return pointer to peer mac address
+ */
+const uint8_t *app_link_peer_mac_get(uint8_t session)
+{
+    return s_app_link_sessions[session].peer_mac;
+}
+
+/**
+ * @brief standby peer mac address of a link session
+ *
+ * @param session link session of peer
+ * @return pointer to standby peer mac address, NULL if session has no standby peer
+ */
+const uint8_t *app_link_standby_mac_get(uint8_t session)
+{
+    return s_app_link_sessions[session].standby_valid ? s_app_link_sessions[session].standby_mac : NULL;
+}
+
+/**
+ * @brief passes a frame received by transport to link protocol, called from transport receive context
+ *
+ * @param mac_addr sender mac address
+ * @param data frame bytes
+ * @param len length of frame
+ * @param rssi RSSI of frame in dBm, 0 if transport does not provide it
+ */
+void app_link_recv(const uint8_t *mac_addr, const uint8_t *data, int len, int8_t rssi)
+{
+    app_link_event_t evt;
+    app_link_event_recv_cb_t *recv_cb = &evt.info.recv_cb;
+    int64_t rx_time = esp_timer_get_time();
+    app_link_session_t *s = NULL;
+
+    size_t header_len = APP_LINK_HEADER_LEN;
+
+    if (mac_addr == NULL || data == NULL || len < APP_LINK_HEADER_LEN) {
+        ESP_LOGE(TAG, "Receive cb arg error");
+        return;
+    }
+
+    // frames of devices other than peers are dropped
+    s = app_link_session_find(mac_addr);
+    if(s == NULL) {
+        return;
+    }
+
+#if CONFIG_LINK_AEAD_ENABLE
+    // forged, replayed and foreign frames are counted by app_aead and dropped
+    size_t opened_len = 0;
+    if(app_aead_open(data, len, s_app_link_aead_rx_buf, &opened_len) != ESP_OK || opened_len < APP_LINK_HEADER_LEN) {
+        return;
+    }
+    data = s_app_link_aead_rx_buf;
+    len = (int)opened_len;
+#endif
+
+#if APP_LINK_FAILOVER_ENABLE
+    // standby peer is heard only after failover, its frames would mix into the stream of the active one
+    if(memcmp(mac_addr, s->peer_mac, APP_LINK_ETH_ALEN) != 0) {
+        return;
+    }
+    s->last_rx_time = rx_time;
+#endif
+
+    if(rssi != 0) {
+        if(s->rssi == 0) {
+            s->rssi = rssi * 16;
+        } else {
+            s->rssi += rssi - (s->rssi / 16);
+        }
+    }
+
+    recv_cb->offset = 0;
+    if(data[0] == APP_LINK_TYPE_DATA) {
+        if(len < APP_LINK_DATA_HEADER_LEN) {
+            ESP_LOGE(TAG, "Receive data frame too short");
+            return;
+        }
+        memcpy(&recv_cb->offset, &data[APP_LINK_HEADER_LEN], sizeof(recv_cb->offset));
+        header_len = APP_LINK_DATA_HEADER_LEN;
+        app_link_sched_charge(APP_LINK_SCHED_DATA_RX, len);
+        s->rx_bytes += len;
+    }
+
+    evt.id = APP_LINK_RECV_CB;
+    memcpy(recv_cb->mac_addr, mac_addr, APP_LINK_ETH_ALEN);
+    recv_cb->session = app_link_session_index(s);
+    recv_cb->data = pvPortMalloc(len-header_len+1);
+    if (recv_cb->data == NULL) {
+        ESP_LOGE(TAG, "Malloc receive data fail");
+        return;
+    }
+
+    recv_cb->type = data[0];
+    recv_cb->ser_count = data[1];
+    recv_cb->rx_time = rx_time;
+
+    memcpy(recv_cb->data, &data[header_len], len-header_len);
+    recv_cb->data_len = len-header_len;
+
+    // if ack, then release the ack semaphore
+    if(data[0] == APP_LINK_TYPE_ACK) {
+        data_ack_t data_ack;
+        if(recv_cb->data_len < sizeof(data_ack)) {
+            vPortFree(recv_cb->data);
+            return;
+        }
+        memcpy(&data_ack, &recv_cb->data[0], sizeof(data_ack));
+        if(data_ack.type == APP_LINK_TYPE_DATA) {
+            s->last_data_ack_offset = data_ack.offset;
+            s->last_data_ack_busy = (data_ack.ser_count & APP_LINK_DATA_ACK_FLAG_BUSY) != 0;
+            xSemaphoreGive(s->data_ack);
+        } else if(data_ack.type == s->last_ack.type && data_ack.ser_count == s->last_ack.ser_count) {
+            s->send_status = true;
+            xSemaphoreGive(s->ack);
+        }
+        vPortFree(recv_cb->data);
+        return;
+    }
+
+    // fill the s_app_link_queue data queue
+    if (xQueueSend(s_app_link_queue, &evt, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Send receive queue fail");
+        vPortFree(recv_cb->data);
+    } else {
+// if WiSer USB device, then send ack from here
+#if DEVICE_WISER_USB
+        if(data[0] == APP_LINK_TYPE_DATA) {
+            app_link_data_offset_ack_send(s, recv_cb->offset + recv_cb->data_len, 0);
+        }
+#endif
+    }
+}
+
+/**
+ * @brief notifies link protocol that transport can reach the peer
+ *
+ */
+void app_link_transport_up(void)
+{
+    app_link_event_t evt;
+
+    evt.id = APP_LINK_TRANSPORT_UP;
+    if (xQueueSend(s_app_link_queue, &evt, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Send transport up queue fail");
+    }
+}
+
+/** @} */ // End of app_link_global_funcs group
+
+/** @} */ // End of app_link group
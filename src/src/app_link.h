@@ -0,0 +1,483 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_link.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application link protocol header, transport independent peer communication
+ */
+
+#ifndef APP_LINK_H
+#define APP_LINK_H
+
+/**
+ * @defgroup app_link Application link protocol Module
+ * @brief Module for managing framing, sequencing and acknowledgement of peer communication over a selectable transport
+ * @{
+ */
+
+/**
+ * @addtogroup app_link_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "config.h"
+#include "commons.h"
+#include "app_tusb.h"
+#include "app_relay.h"
+/** @} */ // End of app_link_include group
+
+/**
+ * @addtogroup app_link_define
+ * @{
+ */
+
+#define APP_LINK_ETH_ALEN               6
+
+#define APP_LINK_QUEUE_SIZE             200
+
+/* one link session per peer, sessions are numbered from 0 in peer table order */
+#if DEVICE_WISER_RELAY
+#define APP_LINK_SESSION_COUNT          2
+#elif DEVICE_WISER_USB
+#define APP_LINK_SESSION_COUNT          CONFIG_LINK_PEER_COUNT
+#else
+#define APP_LINK_SESSION_COUNT          1
+#endif
+/* session of the peer serving clock sync, TDMA and transmit power control */
+#define APP_LINK_SESSION_DEFAULT        0
+
+/* data payload size used until peer capabilities are known, fits ESP-NOW v1 250 byte frames */
+#define APP_LINK_SEND_DATA_SIZE         240
+
+/* every frame starts with type and serial count, data frames add a 32 bit stream byte offset */
+#define APP_LINK_HEADER_LEN             2
+#define APP_LINK_DATA_HEADER_LEN        (APP_LINK_HEADER_LEN + sizeof(uint32_t))
+
+/* largest frame of any transport (ESP-NOW v2 payload, UDP datagram within 1500 byte IP MTU) */
+#define APP_LINK_FRAME_LEN_MAX          1470
+#define APP_LINK_SEND_DATA_SIZE_MAX     (APP_LINK_FRAME_LEN_MAX - APP_LINK_DATA_HEADER_LEN)
+
+/* size of the data retransmit buffer in bytes, must be power of 2 */
+#define APP_LINK_TX_STREAM_SIZE         8192
+
+/* data frames carry flags in place of serial count */
+#define APP_LINK_DATA_FLAG_SYN          0x01    /**< stream start, set until first ack from peer */
+#define APP_LINK_DATA_FLAG_RETX         0x02    /**< frame is a retransmission */
+/* data acks carry flags in place of serial count */
+#define APP_LINK_DATA_ACK_FLAG_BUSY     0x01    /**< receiver had no room, frame was not taken and is sent again later */
+
+typedef enum {
+    APP_LINK_TYPE_DATA=0,
+    APP_LINK_TYPE_CONFIG_SETTINGS,
+    APP_LINK_TYPE_CONFIG_HW_LINE,
+    APP_LINK_TYPE_DEVICE_CONN,
+    APP_LINK_TYPE_CONFIG_REQ,
+    APP_LINK_TYPE_ACK,
+    APP_LINK_TYPE_LINK_CAPS,
+    APP_LINK_TYPE_TIME_SYNC,
+    APP_LINK_TYPE_TDMA_ASSIGN,
+    APP_LINK_TYPE_LINK_REPORT,
+    APP_LINK_TYPE_FLOW_CTRL,
+    APP_LINK_TYPE_SERIAL_STATE,
+    APP_LINK_TYPE_AUTOBAUD,
+} app_link_type_t;
+
+/* airtime scheduler classes */
+typedef enum {
+    APP_LINK_SCHED_DATA_TX=0,   /**< data sent by this device */
+    APP_LINK_SCHED_DATA_RX,     /**< data sent by peer */
+    APP_LINK_SCHED_CTRL,        /**< control frames sent by this device */
+    APP_LINK_SCHED_ACK,         /**< acknowledgements sent by this device */
+    APP_LINK_SCHED_CLASS_COUNT,
+} app_link_sched_id_t;
+
+typedef enum {
+    APP_LINK_RECV_CB,
+    APP_LINK_TRANSPORT_UP,
+    APP_LINK_FAILOVER,
+} app_link_event_id_t;
+
+/** @} */ // End of app_link_define group
+
+/**
+ * @addtogroup app_link_types
+ * @{
+ */
+typedef struct {
+    uint8_t mac_addr[APP_LINK_ETH_ALEN];
+    uint8_t session;        /**< link session of sender */
+    uint8_t type;
+    uint8_t ser_count;      /**< serial count, or APP_LINK_DATA_FLAG_* for data frames */
+    uint32_t offset;        /**< stream byte offset of first data byte, data frames only */
+    size_t data_len;
+    uint8_t *data;
+    int64_t rx_time;        /**< local esp_timer time the frame was received */
+} app_link_event_recv_cb_t;
+
+typedef struct {
+    uint8_t session;        /**< link session which switched to its standby peer */
+} app_link_event_failover_t;
+
+typedef union {
+    app_link_event_recv_cb_t recv_cb;
+    app_link_event_failover_t failover;
+} app_link_event_info_t;
+
+/* When transport receives a frame, comes up or a session fails over, post event to link task. */
+typedef struct {
+    app_link_event_id_t id;
+    app_link_event_info_t info;
+} app_link_event_t;
+
+/* outgoing byte stream, bytes stay buffered until acknowledged by peer */
+typedef struct {
+    uint8_t buf[APP_LINK_TX_STREAM_SIZE];
+    volatile uint32_t una;  /**< offset of oldest unacknowledged byte */
+    volatile uint32_t nxt;  /**< offset one past the last queued byte */
+    uint32_t isn;           /**< initial offset of the stream */
+    bool syn;               /**< true until peer acknowledges first frame */
+} app_link_tx_stream_t;
+
+/* incoming byte stream */
+typedef struct {
+    bool synced;            /**< true once first frame from peer is received */
+    uint32_t isn;           /**< initial offset of the peer stream */
+    uint32_t nxt;           /**< offset of next byte expected from peer */
+} app_link_rx_stream_t;
+
+/* link statistics reported in telemetry, counters wrap */
+typedef struct {
+    uint32_t frames_sent;       /**< data frames sent including retransmissions */
+    uint32_t frames_retx;       /**< data frames retransmitted */
+    uint32_t frames_dropped;    /**< data frames given up after all retries */
+    uint32_t frames_busy;       /**< data frames refused by peer without room, sent again without counting as loss */
+    uint32_t bytes_acked;       /**< stream bytes acknowledged by peer */
+    uint32_t loss;              /**< data frame loss of last adaptation window in percent */
+    size_t mtu;                 /**< data payload size negotiated with peer */
+    size_t chunk;               /**< data payload size currently in use */
+    uint32_t tx_rate;           /**< data sent to peer in bytes per second, including frame headers */
+    uint32_t rx_rate;           /**< data received from peer in bytes per second, including frame headers */
+    int8_t rssi;                /**< average RSSI of frames received from peer in dBm */
+    int8_t tx_power;            /**< transmit power in units of 0.25 dBm */
+    uint8_t hops;               /**< radio hops to the far end device, more than 1 through relays */
+    uint32_t crypto_bytes;      /**< frame bytes encrypted and decrypted by app_aead */
+    uint32_t crypto_time_us;    /**< time spent encrypting and decrypting in microseconds */
+    uint32_t crypto_rejected;   /**< received frames failing authentication or replay check */
+    uint32_t failovers;         /**< switches between active and standby WiSer-USB */
+} app_link_stats_t;
+
+/* link session with one peer */
+typedef struct {
+    uint8_t peer_mac[APP_LINK_ETH_ALEN];
+    uint8_t standby_mac[APP_LINK_ETH_ALEN]; /**< peer taking over when the active one goes silent */
+    bool standby_valid;
+    volatile int64_t last_rx_time;  /**< esp_timer time of last frame from active peer */
+    int64_t unacked_since;          /**< esp_timer time the data frame in flight first went unacknowledged */
+    app_link_tx_stream_t tx;
+    app_link_rx_stream_t rx;
+    volatile size_t mtu;            /**< data payload size in use, starts at v1 size until peer reports its capabilities */
+    volatile size_t chunk;          /**< data payload size of next frame, adapted to frame loss within mtu */
+    uint8_t peer_hops;              /**< relays behind peer reported in its capabilities */
+    uint8_t tx_ser_count;
+    data_ack_t last_ack;            /**< control frame waiting for acknowledgement */
+    bool send_status;
+    volatile uint32_t last_data_ack_offset;
+    volatile bool last_data_ack_busy;   /**< last data ack refused the frame for lack of room */
+    volatile uint32_t send_timeout; /**< acknowledgement wait in ms */
+    uint32_t bitrate;               /**< serial bit rate of data carried */
+    volatile int32_t rssi;          /**< average RSSI of frames from peer in 1/16 dBm, 0 until first frame with RSSI */
+    uint32_t tx_bytes;              /**< data frame bytes sent in current throughput period */
+    uint32_t rx_bytes;              /**< data frame bytes received in current throughput period */
+    config_settings_t config_pending;   /**< config settings waiting for data sent before them */
+    bool config_pending_valid;
+    TickType_t config_pending_tick;
+    uint8_t config_last[APP_LINK_HEADER_LEN + sizeof(config_settings_t)];  /**< last config settings frame, retransmissions are not applied again */
+    app_link_stats_t stats;
+    SemaphoreHandle_t ack;          /**< given when control frame is acknowledged */
+    SemaphoreHandle_t data_ack;     /**< given when data acknowledgement arrives */
+    SemaphoreHandle_t tx_data;      /**< given when bytes are queued to tx stream */
+    SemaphoreHandle_t tx_space;     /**< given when tx stream bytes are acknowledged */
+    SemaphoreHandle_t tx_stream;    /**< guards tx stream writers */
+    SemaphoreHandle_t ctrl_send;    /**< one control frame in flight, from serial count until its ack */
+    uint8_t frame[APP_LINK_DATA_HEADER_LEN + APP_LINK_SEND_DATA_SIZE_MAX];  /**< data frame being sent */
+} app_link_session_t;
+
+/* airtime scheduler class state, virtual time advances by frame bytes divided by weight */
+typedef struct {
+    uint32_t weight;            /**< share of airtime relative to other classes */
+    uint32_t vtime;             /**< weighted airtime used, wraps */
+    TickType_t last_tick;       /**< tick of last frame of class */
+    volatile uint32_t pending;  /**< frames waiting for send lock */
+    uint32_t bytes;             /**< bytes in current throughput period */
+    uint32_t rate;              /**< bytes per second in last throughput period */
+} app_link_sched_class_t;
+
+/* called under send lock just before a frame goes to the transport, to stamp it with its transmit time */
+typedef void (*app_link_presend_cb_t)(uint8_t *data, size_t len);
+
+/* radio transport carrying link frames, see app_espnow and app_udp */
+typedef struct {
+    const char *name;
+    esp_err_t (*init)(void);                                                    /**< bring up radio, frames received are passed to app_link_recv */
+    esp_err_t (*send)(const uint8_t *peer_mac, const uint8_t *data, size_t len); /**< send one frame to peer */
+    size_t (*frame_len_max_get)(void);                                         /**< largest frame the transport can carry */
+    int64_t (*tsf_get)(void);                                                   /**< Wi-Fi TSF shared with peer, 0 if not shared, may be NULL */
+    void (*tx_power_set)(int8_t power);                                         /**< set transmit power in units of 0.25 dBm */
+    int8_t (*tx_power_get)(void);                                               /**< transmit power in units of 0.25 dBm */
+} app_link_transport_t;
+
+/** @} */ // End of app_link_types group
+
+/**
+ * @addtogroup app_link_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize link protocol and selected transport for communication between peers
+ *
+ */
+void app_link_init(void);
+
+/**
+ * @brief deinitialize module
+ *
+ */
+void app_link_deinit(void);
+
+/**
+ * @brief number of link sessions, one per peer
+ *
+ * @return session count
+ */
+uint8_t app_link_session_count_get(void);
+
+/**
+ * @brief queues serial data to be sent to peer, blocks while retransmit buffer is full
+ *
+ * @param session link session of peer
+ * @param  data data packet bytes
+ * @param len length of data bytes
+ */
+void app_link_data_send(uint8_t session, const uint8_t *data, size_t len);
+
+/**
+ * @brief free space of retransmit buffer, app_link_data_send of up to this many bytes does not block
+ *
+ * @param session link session of peer
+ * @return free space in bytes
+ */
+size_t app_link_tx_space_get(uint8_t session);
+
+/**
+ * @brief sends serial config settings to peer, applied by peer after all data queued before this call
+ * @param session link session of peer
+ * @param config_settings config settings to be sent
+ */
+void app_link_config_settings_send(uint8_t session, const config_settings_t config_settings);
+
+/**
+ * @brief sends serial hw line state to peer
+ * @param session link session of peer
+ * @param config_hw_line config hw line state to be sent
+ */
+void app_link_config_hw_line_send(uint8_t session, const config_hw_line_t config_hw_line);
+
+/**
+ * @brief sends connection indication event to peer
+ * @param session link session of peer
+ * @param device_conn connection indication parameters
+ */
+void app_link_device_conn_send(uint8_t session, const device_conn_t device_conn);
+
+/**
+ * @brief sends XON/XOFF state of target to peer
+ * @param session link session of peer
+ * @param flow_ctrl XON/XOFF state
+ */
+void app_link_flow_ctrl_send(uint8_t session, const flow_ctrl_t flow_ctrl);
+
+/**
+ * @brief sends UART errors and line state of target to peer
+ * @param session link session of peer
+ * @param serial_state UART errors and line state
+ */
+void app_link_serial_state_send(uint8_t session, const serial_state_t serial_state);
+
+/**
+ * @brief sends bitrate of target detected by auto-baud to peer
+ * @param session link session of peer
+ * @param autobaud detected bitrate
+ */
+void app_link_autobaud_send(uint8_t session, const autobaud_t autobaud);
+
+/**
+ * @brief sends serial configuration request to peer
+ * @param session link session of peer
+ */
+void app_link_config_req_send(uint8_t session);
+
+/**
+ * @brief data payload size negotiated with peer
+ *
+ * @param session link session of peer
+ * @return data payload size in bytes
+ */
+size_t app_link_mtu_get(uint8_t session);
+
+/**
+ * @brief link statistics of one hop for telemetry
+ *
+ * @param session link session of peer
+ * @param stats filled with counters and current frame sizes
+ */
+void app_link_stats_get(uint8_t session, app_link_stats_t *stats);
+
+/**
+ * @brief updates ack wait timeout for the serial bit rate and current data payload size
+ *
+ * @param session link session of peer
+ * @param bitrate serial bit rate
+ */
+void app_link_send_timeout_update(uint8_t session, uint32_t bitrate);
+
+/**
+ * @brief sends time sync frame to peer without acknowledgement, stamping transmit time
+ *
+ * @param session link session of peer
+ * @param time_sync time sync frame, t1 of requests or t3 of responses is set to transmit time
+ */
+void app_link_time_sync_send(uint8_t session, time_sync_t *time_sync);
+
+/**
+ * @brief sends TDMA slot assignment to peer
+ * @param session link session of peer
+ * @param tdma_assign slot assignment
+ */
+void app_link_tdma_assign_send(uint8_t session, const tdma_assign_t tdma_assign);
+
+/**
+ * @brief sends link report to peer without acknowledgement
+ * @param session link session of peer
+ * @param link_report local view of the link
+ */
+void app_link_report_send(uint8_t session, const link_report_t link_report);
+
+/**
+ * @brief average RSSI of frames received from peer
+ *
+ * @param session link session of peer
+ * @return RSSI in dBm, 0 if transport does not provide it
+ */
+int8_t app_link_rssi_get(uint8_t session);
+
+/**
+ * @brief radio hops to the far end device, learned from capabilities relayed along the path
+ *
+ * @param session link session of peer
+ * @return hop count, 1 for a direct link
+ */
+uint8_t app_link_hops_get(uint8_t session);
+
+/**
+ * @brief sets transmit power of transport
+ *
+ * @param power transmit power in units of 0.25 dBm
+ */
+void app_link_tx_power_set(int8_t power);
+
+/**
+ * @brief transmit power of transport
+ *
+ * @return transmit power in units of 0.25 dBm
+ */
+int8_t app_link_tx_power_get(void);
+
+/**
+ * @brief Wi-Fi TSF of transport if it is shared with peer
+ *
+ * @return TSF in microseconds, 0 if transport has no shared TSF
+ */
+int64_t app_link_tsf_get(void);
+
+/**
+ * @brief operating channel of the pair, from NVS override, derived from pair MAC addresses or default
+ *
+ * @return channel
+ */
+uint8_t app_link_channel_get(void);
+
+/**
+ * @brief derives operating channel of a pair from MAC addresses of both its devices, same for either order
+ *
+ * @param mac_a mac address of one device
+ * @param mac_b mac address of other device
+ * @return channel
+ */
+uint8_t app_link_channel_pair_derive(const uint8_t *mac_a, const uint8_t *mac_b);
+
+/**
+ * @brief peer mac address of a link session
+ *
+ * @param session link session of peer
+ * @return pointer to peer mac address
+ */
+const uint8_t *app_link_peer_mac_get(uint8_t session);
+
+/**
+ * @brief standby peer mac address of a link session
+ *
+ * @param session link session of peer
+ * @return pointer to standby peer mac address, NULL if session has no standby peer
+ */
+const uint8_t *app_link_standby_mac_get(uint8_t session);
+
+/**
+ * @brief passes a frame received by transport to link protocol, called from transport receive context
+ *
+ * @param mac_addr sender mac address
+ * @param data frame bytes
+ * @param len length of frame
+ * @param rssi RSSI of frame in dBm, 0 if transport does not provide it
+ */
+void app_link_recv(const uint8_t *mac_addr, const uint8_t *data, int len, int8_t rssi);
+
+/**
+ * @brief notifies link protocol that transport can reach the peer
+ *
+ */
+void app_link_transport_up(void);
+
+/** @} */ // End of app_link_global_funcs group
+
+/** @} */ // End of app_link group
+
+#endif
@@ -0,0 +1,232 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_relay.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application relay module which forwards serial data and control between two peers
+ *
+ * The relay terminates a link session with each of its peers, so every hop has its own
+ * acknowledgement, retransmission and frame size adaptation. Data delivered in order on
+ * one session is queued to the stream of the other session, and is only acknowledged to
+ * the sender once queued. A frame lost on one hop is retried on that hop alone.
+ */
+
+/**
+ * @defgroup app_relay Application relay Module
+ * @brief Module for forwarding serial data and control between two peers of a relay
+ * @{
+ */
+
+/**
+ * @addtogroup app_relay_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "commons.h"
+#include "esp_log.h"
+#include "app_link.h"
+#include "app_conn.h"
+#include "app_relay.h"
+
+/** @} */ // End of app_relay_include group
+
+#if DEVICE_WISER_RELAY
+/**
+ * @addtogroup app_relay_static_vars
+ * @{
+ */
+
+/**
+ * @brief Tag used for logging in this module
+ */
+static const char *TAG = "app_relay";
+
+/** @} */ // End of app_relay_static_vars group
+
+/**
+ * @addtogroup app_relay_static_funcs
+ * @{
+ */
+
+/**
+ * @brief session on the other side of the relay
+ *
+ * @param session link session
+ * @return other link session
+ */
+static uint8_t app_relay_session_other(uint8_t session);
+
+/** @} */ // End of app_relay_static_funcs group
+
+/**
+ * @addtogroup app_relay_static_funcs
+ * @{
+ */
+
+/**
+ * @brief session on the other side of the relay
+ *
+ * @param session link session
+ * @return other link session
+ */
+static uint8_t app_relay_session_other(uint8_t session)
+{
+    return (session == APP_RELAY_SESSION_UPSTREAM) ? APP_RELAY_SESSION_DOWNSTREAM : APP_RELAY_SESSION_UPSTREAM;
+}
+
+/** @} */ // End of app_relay_static_funcs group
+
+/**
+ * @addtogroup app_relay_global_funcs
+ * @{
+ */
+
+/**
+ * @brief forwards serial data received from one peer to the other
+ *
+ * @param session link session data was received on
+ * @param data data bytes
+ * @param len length of data
+ * @return false if the other hop has no room, data is then left to the sender to send again
+ */
+bool IRAM_ATTR app_relay_data_received(uint8_t session, const uint8_t *data, size_t len)
+{
+    uint8_t other = app_relay_session_other(session);
+
+    // link task also carries acks of the other hop, so it never waits for room here
+    if(app_link_tx_space_get(other) < len) {
+        return false;
+    }
+    app_link_data_send(other, data, len);
+    return true;
+}
+
+/**
+ * @brief forwards serial config settings received from upstream peer to downstream peer
+ *
+ * @param session link session settings were received on
+ * @param config_settings config settings
+ */
+void app_relay_config_settings_received(uint8_t session, const config_settings_t config_settings)
+{
+    if(session != APP_RELAY_SESSION_UPSTREAM) {
+        return;
+    }
+    // both hops carry data at the serial rate of the target
+    app_link_send_timeout_update(APP_RELAY_SESSION_UPSTREAM, config_settings.bitrate);
+    app_link_send_timeout_update(APP_RELAY_SESSION_DOWNSTREAM, config_settings.bitrate);
+    // settings are released once all upstream data before them is queued downstream,
+    // so the downstream switch point follows the same bytes
+    app_link_config_settings_send(APP_RELAY_SESSION_DOWNSTREAM, config_settings);
+}
+
+/**
+ * @brief forwards serial hw line state received from upstream peer to downstream peer
+ *
+ * @param session link session state was received on
+ * @param config_hw_line hw line state
+ */
+void app_relay_config_hw_line_received(uint8_t session, const config_hw_line_t config_hw_line)
+{
+    if(session == APP_RELAY_SESSION_UPSTREAM) {
+        app_link_config_hw_line_send(APP_RELAY_SESSION_DOWNSTREAM, config_hw_line);
+    }
+}
+
+/**
+ * @brief forwards connection indication received from one peer to the other
+ *
+ * @param session link session indication was received on
+ * @param device_conn connection indication parameters
+ */
+void app_relay_device_conn_received(uint8_t session, const device_conn_t device_conn)
+{
+    app_link_device_conn_send(app_relay_session_other(session), device_conn);
+}
+
+/**
+ * @brief forwards XON/XOFF state of target received from downstream peer to upstream peer
+ *
+ * @param session link session state was received on
+ * @param flow_ctrl XON/XOFF state
+ */
+void app_relay_flow_ctrl_received(uint8_t session, const flow_ctrl_t flow_ctrl)
+{
+    if(session == APP_RELAY_SESSION_DOWNSTREAM) {
+        flow_ctrl_t forward = flow_ctrl;
+        // timestamp is on downstream clock, upstream peer is only synchronized with this relay
+        forward.time = 0;
+        app_link_flow_ctrl_send(APP_RELAY_SESSION_UPSTREAM, forward);
+    }
+}
+
+/**
+ * @brief forwards UART errors and line state of target received from downstream peer to upstream peer
+ *
+ * @param session link session state was received on
+ * @param serial_state UART errors and line state
+ */
+void app_relay_serial_state_received(uint8_t session, const serial_state_t serial_state)
+{
+    if(session == APP_RELAY_SESSION_DOWNSTREAM) {
+        app_link_serial_state_send(APP_RELAY_SESSION_UPSTREAM, serial_state);
+    }
+}
+
+/**
+ * @brief forwards bitrate of target detected by auto-baud from downstream peer to upstream peer
+ *
+ * @param session link session bitrate was received on
+ * @param autobaud detected bitrate
+ */
+void app_relay_autobaud_received(uint8_t session, const autobaud_t autobaud)
+{
+    if(session == APP_RELAY_SESSION_DOWNSTREAM) {
+        app_link_autobaud_send(APP_RELAY_SESSION_UPSTREAM, autobaud);
+    }
+}
+
+/**
+ * @brief forwards serial configuration request received from downstream peer to upstream peer
+ *
+ * @param session link session request was received on
+ */
+void app_relay_config_req_received(uint8_t session)
+{
+    if(session == APP_RELAY_SESSION_DOWNSTREAM) {
+        ESP_LOGE(TAG, "config request forwarded upstream");
+        app_link_config_req_send(APP_RELAY_SESSION_UPSTREAM);
+    }
+}
+
+/** @} */ // End of app_relay_global_funcs group
+#endif
+
+/** @} */ // End of app_relay module
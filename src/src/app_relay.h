@@ -0,0 +1,145 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_relay.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application relay header
+ */
+
+#ifndef APP_RELAY_H
+#define APP_RELAY_H
+
+/**
+ * @defgroup app_relay Application relay Module
+ * @brief Module for forwarding serial data and control between two peers of a relay
+ * @{
+ */
+
+/**
+ * @addtogroup app_relay_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "commons.h"
+/** @} */ // End of app_relay_include group
+
+/**
+ * @addtogroup app_relay_define
+ * @{
+ */
+
+/* 1 for WiSer relay between a WiSer-USB and a WiSer-UART */
+#if (DEVICE_CONFIG_MODE == DEVICE_CONFIG_MODE_RELAY)
+#define DEVICE_WISER_RELAY  1
+#else
+#define DEVICE_WISER_RELAY  0
+#endif
+
+/* link sessions of the relay, upstream peer is towards WiSer-USB */
+#define APP_RELAY_SESSION_UPSTREAM      0
+#define APP_RELAY_SESSION_DOWNSTREAM    1
+
+/** @} */ // End of app_relay_define group
+
+#if DEVICE_WISER_RELAY
+/**
+ * @addtogroup app_relay_global_funcs
+ * @{
+ */
+
+/**
+ * @brief forwards serial data received from one peer to the other
+ *
+ * @param session link session data was received on
+ * @param data data bytes
+ * @param len length of data
+ * @return false if the other hop has no room, data is then left to the sender to send again
+ */
+bool app_relay_data_received(uint8_t session, const uint8_t *data, size_t len);
+
+/**
+ * @brief forwards serial config settings received from upstream peer to downstream peer
+ *
+ * @param session link session settings were received on
+ * @param config_settings config settings
+ */
+void app_relay_config_settings_received(uint8_t session, const config_settings_t config_settings);
+
+/**
+ * @brief forwards serial hw line state received from upstream peer to downstream peer
+ *
+ * @param session link session state was received on
+ * @param config_hw_line hw line state
+ */
+void app_relay_config_hw_line_received(uint8_t session, const config_hw_line_t config_hw_line);
+
+/**
+ * @brief forwards connection indication received from one peer to the other
+ *
+ * @param session link session indication was received on
+ * @param device_conn connection indication parameters
+ */
+void app_relay_device_conn_received(uint8_t session, const device_conn_t device_conn);
+
+/**
+ * @brief forwards XON/XOFF state of target received from downstream peer to upstream peer
+ *
+ * @param session link session state was received on
+ * @param flow_ctrl XON/XOFF state
+ */
+void app_relay_flow_ctrl_received(uint8_t session, const flow_ctrl_t flow_ctrl);
+
+/**
+ * @brief forwards UART errors and line state of target received from downstream peer to upstream peer
+ *
+ * @param session link session state was received on
+ * @param serial_state UART errors and line state
+ */
+void app_relay_serial_state_received(uint8_t session, const serial_state_t serial_state);
+
+/**
+ * @brief forwards bitrate of target detected by auto-baud from downstream peer to upstream peer
+ *
+ * @param session link session bitrate was received on
+ * @param autobaud detected bitrate
+ */
+void app_relay_autobaud_received(uint8_t session, const autobaud_t autobaud);
+
+/**
+ * @brief forwards serial configuration request received from downstream peer to upstream peer
+ *
+ * @param session link session request was received on
+ */
+void app_relay_config_req_received(uint8_t session);
+
+/** @} */ // End of app_relay_global_funcs group
+#endif
+
+/** @} */ // End of app_relay group
+
+#endif
@@ -0,0 +1,589 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_sniffer.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application sniffer module which captures ESP-NOW link frames of a pair from air and reports them to host over USB CDC
+ *
+ * The sniffer never transmits. Wi-Fi runs in promiscuous mode on the channel of the pair and
+ * every ESP-NOW frame between the two devices stored under "sniff_mac_0" and "sniff_mac_1" in
+ * NVS is decoded and written to host as one CSV line:
+ *
+ *   time_us,dir,wifi_seq,wifi_retry,rssi,noise_floor,rate,len,type,ser,offset,flags,payload
+ *
+ * Lines starting with '#' carry the column header and per direction counters of each report period.
+ */
+
+/**
+ * @defgroup app_sniffer Application sniffer Module
+ * @brief Module for passively capturing link frames of a pair and reporting them to host
+ * @{
+ */
+
+/**
+ * @addtogroup app_sniffer_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "sdkconfig.h"
+#include "config.h"
+#include "commons.h"
+#include "nvs_peer.h"
+#include "led.h"
+#include "app_link.h"
+#include "app_espnow.h"
+#include "app_sniffer.h"
+#if CONFIG_IDF_TARGET_ESP32S2
+#include "tinyusb.h"
+#include "tusb_cdc_acm.h"
+#endif
+
+/** @} */ // End of app_sniffer_include group
+
+#if DEVICE_WISER_SNIFFER
+
+/**
+ * @addtogroup app_sniffer_define
+ * @{
+ */
+
+#if CONFIG_LINK_TRANSPORT != LINK_TRANSPORT_ESPNOW
+#error Sniffer decodes ESP-NOW frames only!
+#endif
+#if CONFIG_LINK_AEAD_ENABLE || (CONFIG_ESPNOW_ENCRYPTION_ENABLE && !CONFIG_ESPNOW_BROADCAST_ENABLE)
+#error Sniffer decodes unencrypted link frames only, set CONFIG_ESPNOW_ENCRYPTION_ENABLE and CONFIG_LINK_AEAD_ENABLE to 0 on the pair!
+#endif
+
+#define APP_SNIFFER_QUEUE_SIZE      64
+
+/* 802.11 management frame layout */
+#define APP_SNIFFER_WIFI_HDR_LEN    24
+#define APP_SNIFFER_WIFI_FCS_LEN    4
+#define APP_SNIFFER_WIFI_FC_ACTION  0xD0    /**< frame control byte 0 of action frame */
+#define APP_SNIFFER_WIFI_FC_RETRY   0x08    /**< frame control byte 1 retry flag */
+#define APP_SNIFFER_WIFI_FC_PROTECT 0x40    /**< frame control byte 1 protected flag */
+#define APP_SNIFFER_WIFI_ADDR1      4       /**< receiver address */
+#define APP_SNIFFER_WIFI_ADDR2      10      /**< transmitter address */
+#define APP_SNIFFER_WIFI_SEQ_CTRL   22
+
+/* ESP-NOW action frame body: category, OUI, random value, then vendor specific elements */
+#define APP_SNIFFER_ESPNOW_CATEGORY 0x7F
+#define APP_SNIFFER_ESPNOW_HDR_LEN  8
+#define APP_SNIFFER_ESPNOW_ELEM_ID  0xDD
+#define APP_SNIFFER_ESPNOW_TYPE     0x04
+#define APP_SNIFFER_ESPNOW_ELEM_HDR 7       /**< element id, length, OUI, type and version */
+
+/* longest wait for room in CDC fifo before a line is dropped */
+#define APP_SNIFFER_WRITE_TIMEOUT_MS    20
+/* RX LED stays on while frames keep arriving within this time */
+#define APP_SNIFFER_LED_MS              10
+
+#define APP_SNIFFER_LINE_LEN        (160 + 2 * CONFIG_SNIFFER_PAYLOAD_LEN)
+
+/** @} */ // End of app_sniffer_define group
+
+/**
+ * @addtogroup app_sniffer_static_vars
+ * @{
+ */
+static const char *TAG = "app_sniffer";
+
+static const uint8_t s_app_sniffer_espnow_oui[] = { 0x18, 0xFE, 0x34 };
+
+/* devices of the watched pair */
+static uint8_t s_app_sniffer_mac[2][APP_LINK_ETH_ALEN];
+static bool s_app_sniffer_pair_valid = false;
+
+static QueueHandle_t s_app_sniffer_queue = NULL;
+
+/* frames lost to full queue and lines lost to full CDC fifo, reset each report period */
+static volatile uint32_t s_app_sniffer_frames_dropped = 0;
+static uint32_t s_app_sniffer_lines_dropped = 0;
+
+static app_sniffer_stats_t s_app_sniffer_stats[2];
+
+/* set when host opens the port, column header is written before next line */
+static volatile bool s_app_sniffer_header_pending = true;
+
+static const char *s_app_sniffer_type_name[] = {
+    [APP_LINK_TYPE_DATA] = "DATA",
+    [APP_LINK_TYPE_CONFIG_SETTINGS] = "CONFIG",
+    [APP_LINK_TYPE_CONFIG_HW_LINE] = "HW_LINE",
+    [APP_LINK_TYPE_DEVICE_CONN] = "CONN",
+    [APP_LINK_TYPE_CONFIG_REQ] = "CONFIG_REQ",
+    [APP_LINK_TYPE_ACK] = "ACK",
+    [APP_LINK_TYPE_LINK_CAPS] = "CAPS",
+    [APP_LINK_TYPE_TIME_SYNC] = "TIME_SYNC",
+    [APP_LINK_TYPE_TDMA_ASSIGN] = "TDMA",
+    [APP_LINK_TYPE_LINK_REPORT] = "REPORT",
+    [APP_LINK_TYPE_FLOW_CTRL] = "FLOW",
+    [APP_LINK_TYPE_SERIAL_STATE] = "SERIAL_STATE",
+    [APP_LINK_TYPE_AUTOBAUD] = "AUTOBAUD",
+};
+
+static const char *s_app_sniffer_dir_name[] = {
+    [APP_SNIFFER_DIR_01] = "0>1",
+    [APP_SNIFFER_DIR_10] = "1>0",
+    [APP_SNIFFER_DIR_OTHER] = "?",
+};
+
+/** @} */ // End of app_sniffer_static_vars group
+
+/**
+ * @addtogroup app_sniffer_static_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize wifi in promiscuous mode, nothing is transmitted
+ *
+ * @param channel channel of the pair
+ */
+static void app_sniffer_wifi_init(uint8_t channel);
+
+/**
+ * @brief initialize usb cdc port to host
+ *
+ */
+static void app_sniffer_tusb_init(void);
+
+/**
+ * @brief tinyusb rts/dtr line state callback function
+ * @param itf tinyusb instance
+ * @param event rts/dtr state callback event info
+ */
+static void app_sniffer_line_state_changed_callback(int itf, cdcacm_event_t *event);
+
+/**
+ * @brief promiscuous receive callback, runs in Wi-Fi task so only filters and queues frames of the pair
+ *
+ * @param buf received packet
+ * @param type packet type
+ */
+static void app_sniffer_rx_cb(void *buf, wifi_promiscuous_pkt_type_t type);
+
+/**
+ * @brief task which writes captured frames and periodic counters to host
+ *
+ * @param pvParameter task parameters
+ */
+static void app_sniffer_task(void *pvParameter);
+
+/**
+ * @brief decodes one captured frame into a CSV line and updates counters
+ *
+ * @param frame captured frame
+ * @param line line buffer of APP_SNIFFER_LINE_LEN bytes
+ * @return length of line
+ */
+static int app_sniffer_frame_format(const app_sniffer_frame_t *frame, char *line);
+
+/**
+ * @brief formats counters of the report period as a comment line and resets them
+ *
+ * @param line line buffer of APP_SNIFFER_LINE_LEN bytes
+ * @return length of line
+ */
+static int app_sniffer_stats_format(char *line);
+
+/**
+ * @brief writes one line to host, dropped if host does not read it in time
+ *
+ * @param line line bytes
+ * @param len length of line
+ */
+static void app_sniffer_write(const char *line, size_t len);
+
+/** @} */ // End of app_sniffer_static_funcs group
+
+/**
+ * @addtogroup app_sniffer_static_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize wifi in promiscuous mode, nothing is transmitted
+ *
+ * @param channel channel of the pair
+ */
+static void app_sniffer_wifi_init(uint8_t channel)
+{
+    const wifi_promiscuous_filter_t filter = {
+        .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT,    // ESP-NOW frames are action frames
+    };
+
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK( esp_wifi_init(&cfg) );
+    ESP_ERROR_CHECK( esp_wifi_set_storage(WIFI_STORAGE_RAM) );
+    ESP_ERROR_CHECK( esp_wifi_set_mode(ESPNOW_WIFI_MODE) );
+    esp_wifi_set_ps (WIFI_PS_NONE);
+#if CONFIG_ESPNOW_ENABLE_LONG_RANGE
+    ESP_ERROR_CHECK( esp_wifi_set_protocol(ESPNOW_WIFI_IF, WIFI_PROTOCOL_11B|WIFI_PROTOCOL_11G|WIFI_PROTOCOL_11N|WIFI_PROTOCOL_LR) );
+#endif
+    ESP_ERROR_CHECK( esp_wifi_start());
+    ESP_ERROR_CHECK( esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE));
+
+    ESP_ERROR_CHECK( esp_wifi_set_promiscuous_filter(&filter) );
+    ESP_ERROR_CHECK( esp_wifi_set_promiscuous_rx_cb(app_sniffer_rx_cb) );
+    ESP_ERROR_CHECK( esp_wifi_set_promiscuous(true) );
+}
+
+/**
+ * @brief initialize usb cdc port to host
+ *
+ */
+static void app_sniffer_tusb_init(void)
+{
+    const tinyusb_config_t tusb_cfg = {
+        .string_descriptor = NULL,
+        .external_phy = false,
+    };
+
+    ESP_ERROR_CHECK(tinyusb_driver_install(&tusb_cfg));
+
+    tinyusb_config_cdcacm_t acm_cfg = {
+        .usb_dev = TINYUSB_USBDEV_0,
+        .cdc_port = TINYUSB_CDC_ACM_0,
+        .rx_unread_buf_sz = CONFIG_TINYUSB_CDC_RX_BUFSIZE,
+        .callback_rx = NULL,
+        .callback_rx_wanted_char = NULL,
+        .callback_line_state_changed = &app_sniffer_line_state_changed_callback,
+        .callback_line_coding_changed = NULL
+    };
+    ESP_ERROR_CHECK(tusb_cdc_acm_init(&acm_cfg));
+}
+
+/**
+ * @brief tinyusb rts/dtr line state callback function
+ * @param itf tinyusb instance
+ * @param event rts/dtr state callback event info
+ */
+static void app_sniffer_line_state_changed_callback(int itf, cdcacm_event_t *event)
+{
+    if(event->line_state_changed_data.dtr) {
+        s_app_sniffer_header_pending = true;
+    }
+}
+
+/**
+ * @brief promiscuous receive callback, runs in Wi-Fi task so only filters and queues frames of the pair
+ *
+ * @param buf received packet
+ * @param type packet type
+ */
+static void app_sniffer_rx_cb(void *buf, wifi_promiscuous_pkt_type_t type)
+{
+    const wifi_promiscuous_pkt_t *pkt = (const wifi_promiscuous_pkt_t *)buf;
+    const uint8_t *wifi = pkt->payload;
+    int wifi_len = (int)pkt->rx_ctrl.sig_len - APP_SNIFFER_WIFI_FCS_LEN;
+    app_sniffer_frame_t frame;
+
+    if(type != WIFI_PKT_MGMT || wifi_len < APP_SNIFFER_WIFI_HDR_LEN || wifi[0] != APP_SNIFFER_WIFI_FC_ACTION) {
+        return;
+    }
+
+    const uint8_t *dst = &wifi[APP_SNIFFER_WIFI_ADDR1];
+    const uint8_t *src = &wifi[APP_SNIFFER_WIFI_ADDR2];
+    if(!s_app_sniffer_pair_valid) {
+        frame.dir = APP_SNIFFER_DIR_OTHER;
+    } else if(memcmp(src, s_app_sniffer_mac[0], APP_LINK_ETH_ALEN) == 0
+            && (memcmp(dst, s_app_sniffer_mac[1], APP_LINK_ETH_ALEN) == 0 || (dst[0] & 0x01))) {
+        frame.dir = APP_SNIFFER_DIR_01;
+    } else if(memcmp(src, s_app_sniffer_mac[1], APP_LINK_ETH_ALEN) == 0
+            && (memcmp(dst, s_app_sniffer_mac[0], APP_LINK_ETH_ALEN) == 0 || (dst[0] & 0x01))) {
+        frame.dir = APP_SNIFFER_DIR_10;
+    } else {
+        return;
+    }
+
+    const uint8_t *body = &wifi[APP_SNIFFER_WIFI_HDR_LEN];
+    int body_len = wifi_len - APP_SNIFFER_WIFI_HDR_LEN;
+
+    frame.len = 0;
+    frame.capture_len = 0;
+    frame.sealed = 0;
+    if(wifi[1] & APP_SNIFFER_WIFI_FC_PROTECT) {
+        // pair set up with ESP-NOW encryption unlike the sniffer, only the body size is known
+        if(!s_app_sniffer_pair_valid) {
+            return;
+        }
+        frame.sealed = 1;
+        frame.len = (uint16_t)body_len;
+    } else {
+        if(body_len < APP_SNIFFER_ESPNOW_HDR_LEN || body[0] != APP_SNIFFER_ESPNOW_CATEGORY
+                || memcmp(&body[1], s_app_sniffer_espnow_oui, sizeof(s_app_sniffer_espnow_oui)) != 0) {
+            return;
+        }
+        // link frame is the body of the ESP-NOW vendor specific elements, v2 frames may carry several
+        int pos = APP_SNIFFER_ESPNOW_HDR_LEN;
+        while(pos + APP_SNIFFER_ESPNOW_ELEM_HDR <= body_len) {
+            const uint8_t *elem = &body[pos];
+            int elem_len = elem[1];
+            if(elem[0] != APP_SNIFFER_ESPNOW_ELEM_ID || elem_len < APP_SNIFFER_ESPNOW_ELEM_HDR - 2
+                    || pos + 2 + elem_len > body_len
+                    || memcmp(&elem[2], s_app_sniffer_espnow_oui, sizeof(s_app_sniffer_espnow_oui)) != 0
+                    || elem[5] != APP_SNIFFER_ESPNOW_TYPE) {
+                break;
+            }
+            int data_len = elem_len - (APP_SNIFFER_ESPNOW_ELEM_HDR - 2);
+            int copy = APP_SNIFFER_CAPTURE_LEN - frame.capture_len;
+            copy = (data_len < copy) ? data_len : copy;
+            memcpy(&frame.capture[frame.capture_len], &elem[APP_SNIFFER_ESPNOW_ELEM_HDR], copy);
+            frame.capture_len += copy;
+            frame.len += data_len;
+            pos += 2 + elem_len;
+        }
+        if(frame.len == 0) {
+            return;
+        }
+    }
+
+    frame.time = esp_timer_get_time();
+    frame.rssi = pkt->rx_ctrl.rssi;
+    frame.noise_floor = pkt->rx_ctrl.noise_floor;
+    frame.rate = pkt->rx_ctrl.rate;
+    frame.wifi_seq = (wifi[APP_SNIFFER_WIFI_SEQ_CTRL] | (wifi[APP_SNIFFER_WIFI_SEQ_CTRL + 1] << 8)) >> 4;
+    frame.wifi_retry = (wifi[1] & APP_SNIFFER_WIFI_FC_RETRY) ? 1 : 0;
+
+    if(xQueueSend(s_app_sniffer_queue, &frame, 0) != pdTRUE) {
+        s_app_sniffer_frames_dropped++;
+    }
+}
+
+/**
+ * @brief task which writes captured frames and periodic counters to host
+ *
+ * @param pvParameter task parameters
+ */
+static void app_sniffer_task(void *pvParameter)
+{
+    static app_sniffer_frame_t frame;
+    static char line[APP_SNIFFER_LINE_LEN];
+    int64_t stats_time = esp_timer_get_time();
+
+    while(true) {
+        if(s_app_sniffer_header_pending) {
+            s_app_sniffer_header_pending = false;
+            const char *header = "# time_us,dir,wifi_seq,wifi_retry,rssi,noise_floor,rate,len,type,ser,offset,flags,payload\r\n";
+            app_sniffer_write(header, strlen(header));
+        }
+
+        if(xQueueReceive(s_app_sniffer_queue, &frame, pdMS_TO_TICKS(APP_SNIFFER_LED_MS)) == pdTRUE) {
+            led_rx_on();
+            app_sniffer_write(line, app_sniffer_frame_format(&frame, line));
+        } else {
+            led_rx_off();
+        }
+
+        if(esp_timer_get_time() - stats_time >= CONFIG_SNIFFER_STATS_PERIOD_MS * 1000LL) {
+            stats_time = esp_timer_get_time();
+            app_sniffer_write(line, app_sniffer_stats_format(line));
+        }
+    }
+}
+
+/**
+ * @brief decodes one captured frame into a CSV line and updates counters
+ *
+ * @param frame captured frame
+ * @param line line buffer of APP_SNIFFER_LINE_LEN bytes
+ * @return length of line
+ */
+static int app_sniffer_frame_format(const app_sniffer_frame_t *frame, char *line)
+{
+    const uint8_t *capture = frame->capture;
+    char type_name[12] = "SEALED";
+    char offset[12] = "";
+    char flags[16] = "";
+    unsigned int ser = 0;
+    size_t header_len = frame->capture_len;
+    app_sniffer_stats_t *stats = &s_app_sniffer_stats[(frame->dir == APP_SNIFFER_DIR_10) ? 1 : 0];
+
+    stats->frames++;
+    stats->bytes += frame->len;
+    stats->wifi_retries += frame->wifi_retry;
+
+    if(!frame->sealed && frame->capture_len >= APP_LINK_HEADER_LEN) {
+        uint8_t type = capture[0];
+        ser = capture[1];
+        header_len = APP_LINK_HEADER_LEN;
+        if(type < sizeof(s_app_sniffer_type_name) / sizeof(s_app_sniffer_type_name[0])) {
+            snprintf(type_name, sizeof(type_name), "%s", s_app_sniffer_type_name[type]);
+        } else {
+            snprintf(type_name, sizeof(type_name), "TYPE_%u", type);
+        }
+
+        if(type == APP_LINK_TYPE_DATA && frame->capture_len >= APP_LINK_DATA_HEADER_LEN) {
+            uint32_t data_offset;
+            memcpy(&data_offset, &capture[APP_LINK_HEADER_LEN], sizeof(data_offset));
+            snprintf(offset, sizeof(offset), "%lu", (unsigned long)data_offset);
+            snprintf(flags, sizeof(flags), "%s%s%s", (ser & APP_LINK_DATA_FLAG_SYN) ? "SYN" : "",
+                    ((ser & APP_LINK_DATA_FLAG_SYN) && (ser & APP_LINK_DATA_FLAG_RETX)) ? "|" : "",
+                    (ser & APP_LINK_DATA_FLAG_RETX) ? "RETX" : "");
+            if(ser & APP_LINK_DATA_FLAG_RETX) {
+                stats->link_retx++;
+            }
+            header_len = APP_LINK_DATA_HEADER_LEN;
+        } else if(type == APP_LINK_TYPE_ACK && frame->capture_len >= APP_LINK_HEADER_LEN + sizeof(data_ack_t)) {
+            // ack names the frame it acknowledges
+            data_ack_t data_ack;
+            memcpy(&data_ack, &capture[APP_LINK_HEADER_LEN], sizeof(data_ack));
+            ser = data_ack.ser_count;
+            if(data_ack.type == APP_LINK_TYPE_DATA) {
+                snprintf(offset, sizeof(offset), "%lu", (unsigned long)data_ack.offset);
+            }
+            snprintf(flags, sizeof(flags), "ack:%s", (data_ack.type < sizeof(s_app_sniffer_type_name) / sizeof(s_app_sniffer_type_name[0]))
+                    ? s_app_sniffer_type_name[data_ack.type] : "?");
+            stats->acks++;
+            header_len = APP_LINK_HEADER_LEN + sizeof(data_ack_t);
+        }
+    }
+
+    int len = snprintf(line, APP_SNIFFER_LINE_LEN, "%lld,%s,%u,%u,%d,%d,%u,%u,%s,%u,%s,%s,",
+            (long long)frame->time, s_app_sniffer_dir_name[frame->dir], frame->wifi_seq, frame->wifi_retry,
+            frame->rssi, frame->noise_floor, frame->rate, frame->len, type_name, ser, offset, flags);
+
+    // payload bytes after link header, as far as captured
+    for(size_t i = header_len; i < frame->capture_len && i < header_len + CONFIG_SNIFFER_PAYLOAD_LEN; i++) {
+        len += snprintf(&line[len], APP_SNIFFER_LINE_LEN - len, "%02x", capture[i]);
+    }
+    len += snprintf(&line[len], APP_SNIFFER_LINE_LEN - len, "\r\n");
+    return len;
+}
+
+/**
+ * @brief formats counters of the report period as a comment line and resets them
+ *
+ * @param line line buffer of APP_SNIFFER_LINE_LEN bytes
+ * @return length of line
+ */
+static int app_sniffer_stats_format(char *line)
+{
+    int len = snprintf(line, APP_SNIFFER_LINE_LEN, "# stats");
+
+    for(uint8_t dir = 0; dir < 2; dir++) {
+        const app_sniffer_stats_t *stats = &s_app_sniffer_stats[dir];
+        len += snprintf(&line[len], APP_SNIFFER_LINE_LEN - len, " %s frames=%lu bytes=%lu wifi_retries=%lu link_retx=%lu acks=%lu",
+                s_app_sniffer_dir_name[dir], (unsigned long)stats->frames, (unsigned long)stats->bytes,
+                (unsigned long)stats->wifi_retries, (unsigned long)stats->link_retx, (unsigned long)stats->acks);
+    }
+    len += snprintf(&line[len], APP_SNIFFER_LINE_LEN - len, " frames_dropped=%lu lines_dropped=%lu\r\n",
+            (unsigned long)s_app_sniffer_frames_dropped, (unsigned long)s_app_sniffer_lines_dropped);
+
+    memset(s_app_sniffer_stats, 0, sizeof(s_app_sniffer_stats));
+    s_app_sniffer_frames_dropped = 0;
+    s_app_sniffer_lines_dropped = 0;
+    return len;
+}
+
+/**
+ * @brief writes one line to host, dropped if host does not read it in time
+ *
+ * @param line line bytes
+ * @param len length of line
+ */
+static void app_sniffer_write(const char *line, size_t len)
+{
+    size_t written = 0;
+    TickType_t start = xTaskGetTickCount();
+
+    while(written < len) {
+        written += tinyusb_cdcacm_write_queue(TINYUSB_CDC_ACM_0, (const uint8_t *)&line[written], len - written);
+        tinyusb_cdcacm_write_flush(TINYUSB_CDC_ACM_0, 0);
+        if(written < len) {
+            if((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(APP_SNIFFER_WRITE_TIMEOUT_MS)) {
+                s_app_sniffer_lines_dropped++;
+                return;
+            }
+            vTaskDelay(1);
+        }
+    }
+}
+
+/** @} */ // End of app_sniffer_static_funcs group
+
+/**
+ * @addtogroup app_sniffer_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize sniffer: USB CDC port to host and Wi-Fi in promiscuous mode on channel of the pair
+ *
+ * @return  esp error code
+ */
+int app_sniffer_init(void)
+{
+    uint8_t channel = CONFIG_LINK_CHANNEL;
+    uint8_t channel_nvs = 0;
+
+    nvs_peer_init();
+    nvs_peer_open();
+    s_app_sniffer_pair_valid = nvs_peer_sniff_read(0, s_app_sniffer_mac[0]) && nvs_peer_sniff_read(1, s_app_sniffer_mac[1]);
+    // same channel choice as the pair itself makes
+    if(nvs_peer_channel_read(&channel_nvs) && channel_nvs >= 1 && channel_nvs <= 13) {
+        channel = channel_nvs;
+    } else if(CONFIG_LINK_CHANNEL_AUTO_ENABLE && s_app_sniffer_pair_valid) {
+        channel = app_link_channel_pair_derive(s_app_sniffer_mac[0], s_app_sniffer_mac[1]);
+    }
+    nvs_peer_close();
+
+    if(s_app_sniffer_pair_valid) {
+        for(int i = 0; i < 2; i++) {
+            const uint8_t *mac = s_app_sniffer_mac[i];
+            ESP_LOGE(TAG, "device %d mac address - %02x:%02x:%02x:%02x:%02x:%02x", i, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        }
+    } else {
+        ESP_LOGE(TAG, "sniff_mac_0/sniff_mac_1 missing, capturing ESP-NOW frames of all devices");
+    }
+    ESP_LOGE(TAG, "channel: %u", channel);
+
+    s_app_sniffer_queue = xQueueCreate(APP_SNIFFER_QUEUE_SIZE, sizeof(app_sniffer_frame_t));
+    if(s_app_sniffer_queue == NULL) {
+        ESP_LOGE(TAG, "Create queue fail");
+        return ESP_FAIL;
+    }
+
+    app_sniffer_tusb_init();
+    xTaskCreate(app_sniffer_task, "app_sniffer_task", 4096, NULL, 3, NULL);
+    app_sniffer_wifi_init(channel);
+    return ESP_OK;
+}
+
+/** @} */ // End of app_sniffer_global_funcs group
+#endif
+
+/** @} */ // End of app_sniffer module
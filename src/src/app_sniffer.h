@@ -0,0 +1,124 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_sniffer.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application sniffer header
+ */
+
+#ifndef APP_SNIFFER_H
+#define APP_SNIFFER_H
+
+/**
+ * @defgroup app_sniffer Application sniffer Module
+ * @brief Module for passively capturing link frames of a pair and reporting them to host
+ * @{
+ */
+
+/**
+ * @addtogroup app_sniffer_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "commons.h"
+#include "app_link.h"
+/** @} */ // End of app_sniffer_include group
+
+/**
+ * @addtogroup app_sniffer_define
+ * @{
+ */
+
+/* 1 for WiSer sniffer, WiSer-USB hardware listening to a pair without joining it */
+#if (DEVICE_CONFIG_MODE == DEVICE_CONFIG_MODE_SNIFFER)
+#define DEVICE_WISER_SNIFFER    1
+#else
+#define DEVICE_WISER_SNIFFER    0
+#endif
+
+/* direction of captured frame, device 0 and 1 of the pair are read from NVS */
+#define APP_SNIFFER_DIR_01      0
+#define APP_SNIFFER_DIR_10      1
+#define APP_SNIFFER_DIR_OTHER   2       /**< pair is not configured, frame of any devices */
+
+/* link frame bytes kept for decoding: header and ack body or data header, then payload */
+#define APP_SNIFFER_HEAD_LEN    (APP_LINK_HEADER_LEN + sizeof(data_ack_t))
+#define APP_SNIFFER_CAPTURE_LEN (APP_SNIFFER_HEAD_LEN + CONFIG_SNIFFER_PAYLOAD_LEN)
+
+/** @} */ // End of app_sniffer_define group
+
+/**
+ * @addtogroup app_sniffer_types
+ * @{
+ */
+
+/* link frame captured from air, queued from Wi-Fi task to report task */
+typedef struct {
+    int64_t time;               /**< local esp_timer time the frame was received in microseconds */
+    uint8_t dir;                /**< APP_SNIFFER_DIR_* */
+    int8_t rssi;                /**< RSSI in dBm */
+    int8_t noise_floor;         /**< noise floor in dBm */
+    uint8_t rate;               /**< PHY rate index */
+    uint16_t wifi_seq;          /**< 802.11 sequence number */
+    uint8_t wifi_retry;         /**< 1 if 802.11 retry bit is set, frame is a MAC layer retransmission */
+    uint8_t sealed;             /**< 1 if link frame is encrypted by ESP-NOW or app_aead */
+    uint16_t len;               /**< length of link frame */
+    uint16_t capture_len;       /**< bytes of link frame in capture */
+    uint8_t capture[APP_SNIFFER_CAPTURE_LEN];
+} app_sniffer_frame_t;
+
+/* per direction counters of a report period */
+typedef struct {
+    uint32_t frames;            /**< link frames captured */
+    uint32_t bytes;             /**< link frame bytes captured */
+    uint32_t wifi_retries;      /**< frames with 802.11 retry bit */
+    uint32_t link_retx;         /**< data frames retransmitted by link after missing ack */
+    uint32_t acks;              /**< link acknowledgements */
+} app_sniffer_stats_t;
+
+/** @} */ // End of app_sniffer_types group
+
+#if DEVICE_WISER_SNIFFER
+/**
+ * @addtogroup app_sniffer_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize sniffer: USB CDC port to host and Wi-Fi in promiscuous mode on channel of the pair
+ *
+ * @return  esp error code
+ */
+int app_sniffer_init(void);
+
+/** @} */ // End of app_sniffer_global_funcs group
+#endif
+
+/** @} */ // End of app_sniffer module
+
+#endif /* APP_SNIFFER_H */
@@ -0,0 +1,258 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_tdma.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application TDMA airtime scheduling module which keeps data frames to slots assigned by WiSer-USB
+ *
+ * Frames of CONFIG_TDMA_FRAME_PERIOD_US are aligned to the esp_timer clock of the coordinator
+ * (WiSer-USB). Nodes convert local time to coordinator time with app_tsync. Each device only
+ * starts a data frame while the rest of its own slot can hold the frame and its acknowledgement,
+ * so transmissions of different nodes do not overlap and every node gets a turn once per period.
+ */
+
+/**
+ * @defgroup app_tdma Application TDMA airtime scheduling Module
+ * @brief Module for restricting data transmission to time slots assigned by the WiSer-USB coordinator
+ * @{
+ */
+
+/**
+ * @addtogroup app_tdma_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "commons.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "app_tusb.h"
+#include "app_uart.h"
+#include "app_link.h"
+#include "app_tsync.h"
+#include "app_tdma.h"
+
+/** @} */ // End of app_tdma_include group
+
+/**
+ * @addtogroup app_tdma_define
+ * @{
+ */
+
+/* coordinator slot plus one slot per node */
+#define APP_TDMA_SLOT_COUNT     (1 + CONFIG_TDMA_NODE_COUNT)
+
+#if CONFIG_TDMA_ENABLE && DEVICE_WISER_USB && (CONFIG_TDMA_NODE_COUNT < APP_LINK_SESSION_COUNT)
+#error Each peer gets its own TDMA slot, raise CONFIG_TDMA_NODE_COUNT to at least CONFIG_LINK_PEER_COUNT!
+#endif
+
+/** @} */ // End of app_tdma_define group
+
+/**
+ * @addtogroup app_tdma_static_vars
+ * @{
+ */
+
+/**
+ * @brief Tag used for logging in this module
+ */
+static const char *TAG = "app_tdma";
+
+static tdma_assign_t s_app_tdma_assign;
+static volatile bool s_app_tdma_assigned = false;
+
+/** @} */ // End of app_tdma_static_vars group
+
+/**
+ * @addtogroup app_tdma_static_funcs
+ * @{
+ */
+
+#if DEVICE_WISER_USB
+/**
+ * @brief task which announces slot assignment to each node, repeated so a node that starts late picks it up
+ *
+ * @param pvParameter task parameters
+ */
+static void app_tdma_task(void *pvParameter);
+#endif
+
+/**
+ * @brief current time on coordinator clock
+ *
+ * @param time filled with coordinator time in microseconds
+ * @return true if coordinator time is known
+ */
+static bool app_tdma_coordinator_time_get(int64_t *time);
+
+/** @} */ // End of app_tdma_static_funcs group
+
+/**
+ * @addtogroup app_tdma_static_funcs
+ * @{
+ */
+
+#if DEVICE_WISER_USB
+/**
+ * @brief task which announces slot assignment to each node, repeated so a node that starts late picks it up
+ *
+ * @param pvParameter task parameters
+ */
+static void app_tdma_task(void *pvParameter)
+{
+    tdma_assign_t tdma_assign;
+
+    memcpy(&tdma_assign, &s_app_tdma_assign, sizeof(tdma_assign));
+
+    while (true) {
+        // node of session i gets the slot following the coordinator slot and the slots of earlier sessions
+        for(uint8_t i = 0; i < app_link_session_count_get(); i++) {
+            tdma_assign.slot = APP_TDMA_COORDINATOR_SLOT + 1 + i;
+            app_link_tdma_assign_send(i, tdma_assign);
+        }
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_TDMA_ASSIGN_PERIOD_MS));
+    }
+}
+#endif
+
+/**
+ * @brief current time on coordinator clock
+ *
+ * @param time filled with coordinator time in microseconds
+ * @return true if coordinator time is known
+ */
+static bool IRAM_ATTR app_tdma_coordinator_time_get(int64_t *time)
+{
+#if DEVICE_WISER_USB
+    *time = esp_timer_get_time();
+    return true;
+#else
+    if(!app_tsync_is_synced()) {
+        return false;
+    }
+    *time = app_tsync_peer_time_get();
+    return true;
+#endif
+}
+
+/** @} */ // End of app_tdma_static_funcs group
+
+/**
+ * @addtogroup app_tdma_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize TDMA, coordinator assigns its own slot and starts announcing node slots
+ *
+ */
+void app_tdma_init(void)
+{
+#if CONFIG_TDMA_ENABLE
+#if DEVICE_WISER_USB
+    s_app_tdma_assign.enable = 1;
+    s_app_tdma_assign.slot = APP_TDMA_COORDINATOR_SLOT;
+    s_app_tdma_assign.frame_period = CONFIG_TDMA_FRAME_PERIOD_US;
+    s_app_tdma_assign.slot_len = CONFIG_TDMA_FRAME_PERIOD_US / APP_TDMA_SLOT_COUNT;
+    s_app_tdma_assigned = true;
+    ESP_LOGE(TAG, "coordinator, period: %lu us, slot: %lu us", (unsigned long)s_app_tdma_assign.frame_period, (unsigned long)s_app_tdma_assign.slot_len);
+    xTaskCreate(app_tdma_task, "app_tdma_task", 2048, NULL, 2, NULL);
+#endif
+#endif
+}
+
+/**
+ * @brief applies slot assignment received from coordinator
+ *
+ * @param tdma_assign slot assignment
+ */
+void app_tdma_assign_received(const tdma_assign_t tdma_assign)
+{
+#if DEVICE_WISER_UART
+    if(tdma_assign.frame_period == 0 || tdma_assign.slot_len == 0
+        || (uint64_t)tdma_assign.slot_len * (tdma_assign.slot + 1) > tdma_assign.frame_period) {
+        ESP_LOGE(TAG, "invalid slot assignment");
+        return;
+    }
+    if(!s_app_tdma_assigned || memcmp(&s_app_tdma_assign, &tdma_assign, sizeof(tdma_assign)) != 0) {
+        ESP_LOGE(TAG, "slot: %u, period: %lu us, slot: %lu us", tdma_assign.slot, (unsigned long)tdma_assign.frame_period, (unsigned long)tdma_assign.slot_len);
+    }
+    s_app_tdma_assigned = false;
+    memcpy(&s_app_tdma_assign, &tdma_assign, sizeof(s_app_tdma_assign));
+    s_app_tdma_assigned = (tdma_assign.enable != 0);
+#endif
+}
+
+/**
+ * @brief checks if transmissions are restricted to an assigned slot
+ *
+ * @return true if TDMA is enabled, a slot is assigned and coordinator time is known
+ */
+bool IRAM_ATTR app_tdma_is_active(void)
+{
+    int64_t time;
+
+    return s_app_tdma_assigned && app_tdma_coordinator_time_get(&time);
+}
+
+/**
+ * @brief blocks until current time is inside own slot with room for a frame and its acknowledgement
+ *
+ */
+void IRAM_ATTR app_tdma_tx_wait(void)
+{
+    int64_t time;
+
+    while(s_app_tdma_assigned && app_tdma_coordinator_time_get(&time)) {
+        uint32_t period = s_app_tdma_assign.frame_period;
+        uint32_t slot_start = s_app_tdma_assign.slot * s_app_tdma_assign.slot_len;
+        uint32_t slot_end = slot_start + s_app_tdma_assign.slot_len;
+        uint32_t pos = (uint32_t)(((time % period) + period) % period);
+
+        if(pos >= slot_start && pos + CONFIG_TDMA_GUARD_US <= slot_end) {
+            return;
+        }
+
+        // sleep until own slot starts again
+        uint32_t wait = (pos < slot_start) ? (slot_start - pos) : (period - pos + slot_start);
+        if(wait >= 1000) {
+            vTaskDelay(pdMS_TO_TICKS(wait / 1000));
+        } else {
+            vTaskDelay(1);
+        }
+    }
+}
+
+/** @} */ // End of app_tdma_global_funcs group
+
+/** @} */ // End of app_tdma group
+
+/** @} */ // End of app_tdma module
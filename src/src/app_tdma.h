@@ -0,0 +1,95 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_tdma.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application TDMA airtime scheduling header
+ */
+
+#ifndef APP_TDMA_H
+#define APP_TDMA_H
+
+/**
+ * @defgroup app_tdma Application TDMA airtime scheduling Module
+ * @brief Module for restricting data transmission to time slots assigned by the WiSer-USB coordinator
+ * @{
+ */
+
+/**
+ * @addtogroup app_tdma_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "commons.h"
+/** @} */ // End of app_tdma_include group
+
+/**
+ * @addtogroup app_tdma_define
+ * @{
+ */
+
+/* slot owned by the coordinator, nodes are assigned the following slots */
+#define APP_TDMA_COORDINATOR_SLOT   0
+
+/** @} */ // End of app_tdma_define group
+
+/**
+ * @addtogroup app_tdma_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize TDMA, coordinator assigns its own slot and starts announcing node slots
+ *
+ */
+void app_tdma_init(void);
+
+/**
+ * @brief applies slot assignment received from coordinator
+ *
+ * @param tdma_assign slot assignment
+ */
+void app_tdma_assign_received(const tdma_assign_t tdma_assign);
+
+/**
+ * @brief checks if transmissions are restricted to an assigned slot
+ *
+ * @return true if TDMA is enabled, a slot is assigned and coordinator time is known
+ */
+bool app_tdma_is_active(void);
+
+/**
+ * @brief blocks until current time is inside own slot with room for a frame and its acknowledgement
+ *
+ */
+void app_tdma_tx_wait(void);
+
+/** @} */ // End of app_tdma_global_funcs group
+
+/** @} */ // End of app_tdma group
+
+#endif
@@ -0,0 +1,372 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_tsync.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application peer clock synchronization module which estimates peer esp_timer offset and drift
+ *
+ * Each device periodically sends a request stamped with its transmit time t1, the peer stamps
+ * receive time t2 and transmit time t3, and the requester stamps receive time t4. As in NTP,
+ * offset = ((t2 - t1) + (t3 - t4)) / 2 and delay = (t4 - t1) - (t3 - t2). The exchange with the
+ * lowest delay among recent ones is least disturbed by queueing and is used as the estimate.
+ * When the transport shares a Wi-Fi TSF between both devices, offset is taken from TSF instead.
+ */
+
+/**
+ * @defgroup app_tsync Application peer clock synchronization Module
+ * @brief Module for estimating offset and drift between local and peer esp_timer clocks
+ * @{
+ */
+
+/**
+ * @addtogroup app_tsync_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "commons.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "app_link.h"
+#include "app_tsync.h"
+
+/** @} */ // End of app_tsync_include group
+
+/**
+ * @addtogroup app_tsync_define
+ * @{
+ */
+
+/* shortest interval between estimates used for drift, shorter ones are dominated by jitter */
+#define APP_TSYNC_DRIFT_INTERVAL_MIN    (10 * 1000 * 1000)  // in us
+
+/** @} */ // End of app_tsync_define group
+
+/**
+ * @addtogroup app_tsync_static_vars
+ * @{
+ */
+
+/**
+ * @brief Tag used for logging in this module
+ */
+static const char *TAG = "app_tsync";
+
+static SemaphoreHandle_t xSemaphoreTsync = NULL;
+
+static app_tsync_sample_t s_app_tsync_samples[APP_TSYNC_FILTER_LEN];
+static uint8_t s_app_tsync_sample_count = 0;
+static uint8_t s_app_tsync_sample_index = 0;
+
+/* current estimate, offset at local time ref_time */
+static bool s_app_tsync_synced = false;
+static int64_t s_app_tsync_offset = 0;
+static int64_t s_app_tsync_delay = 0;
+static int64_t s_app_tsync_ref_time = 0;
+static int32_t s_app_tsync_drift = 0;
+
+/* estimate last used for drift */
+static int64_t s_app_tsync_drift_offset = 0;
+static int64_t s_app_tsync_drift_time = 0;
+
+static volatile uint8_t s_app_tsync_seq = 0;
+
+/** @} */ // End of app_tsync_static_vars group
+
+/**
+ * @addtogroup app_tsync_static_funcs
+ * @{
+ */
+
+/**
+ * @brief task which sends time sync requests to peer
+ *
+ * @param pvParameter task parameters
+ */
+static void app_tsync_task(void *pvParameter);
+
+/**
+ * @brief local esp_timer minus Wi-Fi TSF
+ *
+ * @return clock base in microseconds, 0 when TSF is not shared with peer
+ */
+static int64_t app_tsync_tsf_base_get(void);
+
+/**
+ * @brief adds exchange to filter and updates offset and drift estimate
+ *
+ * @param sample completed exchange
+ */
+static void app_tsync_sample_add(const app_tsync_sample_t *sample);
+
+/**
+ * @brief moves estimate to a new offset and updates drift from previous estimate
+ *
+ * @param offset peer clock minus local clock in microseconds
+ * @param delay round trip time of exchange in microseconds
+ * @param local_time local time of offset
+ */
+static void app_tsync_estimate_set(int64_t offset, int64_t delay, int64_t local_time);
+
+/** @} */ // End of app_tsync_static_funcs group
+
+/**
+ * @addtogroup app_tsync_static_funcs
+ * @{
+ */
+
+/**
+ * @brief task which sends time sync requests to peer
+ *
+ * @param pvParameter task parameters
+ */
+static void app_tsync_task(void *pvParameter)
+{
+    time_sync_t time_sync;
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_TSYNC_PERIOD_MS));
+
+        memset(&time_sync, 0, sizeof(time_sync));
+        time_sync.reply = 0;
+        time_sync.seq = ++s_app_tsync_seq;
+        time_sync.tsf_base = app_tsync_tsf_base_get();
+        app_link_time_sync_send(APP_LINK_SESSION_DEFAULT, &time_sync);
+    }
+}
+
+/**
+ * @brief local esp_timer minus Wi-Fi TSF
+ *
+ * @return clock base in microseconds, 0 when TSF is not shared with peer
+ */
+static int64_t app_tsync_tsf_base_get(void)
+{
+#if CONFIG_TSYNC_TSF_ENABLE
+    int64_t tsf = app_link_tsf_get();
+    if(tsf != 0) {
+        return esp_timer_get_time() - tsf;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief moves estimate to a new offset and updates drift from previous estimate
+ *
+ * @param offset peer clock minus local clock in microseconds
+ * @param delay round trip time of exchange in microseconds
+ * @param local_time local time of offset
+ */
+static void app_tsync_estimate_set(int64_t offset, int64_t delay, int64_t local_time)
+{
+    int64_t interval = local_time - s_app_tsync_drift_time;
+
+    if(!s_app_tsync_synced) {
+        s_app_tsync_drift_offset = offset;
+        s_app_tsync_drift_time = local_time;
+        ESP_LOGE(TAG, "synced, offset: %lld us, delay: %lld us", (long long)offset, (long long)delay);
+    } else if(interval >= APP_TSYNC_DRIFT_INTERVAL_MIN) {
+        int64_t drift = ((offset - s_app_tsync_drift_offset) * 1000000000LL) / interval;
+        // smooth drift, offset jitter between estimates is of the order of a few us
+        s_app_tsync_drift = (int32_t)(s_app_tsync_drift + (drift - s_app_tsync_drift) / 8);
+        s_app_tsync_drift_offset = offset;
+        s_app_tsync_drift_time = local_time;
+    }
+
+    s_app_tsync_offset = offset;
+    s_app_tsync_delay = delay;
+    s_app_tsync_ref_time = local_time;
+    s_app_tsync_synced = true;
+}
+
+/**
+ * @brief adds exchange to filter and updates offset and drift estimate
+ *
+ * @param sample completed exchange
+ */
+static void app_tsync_sample_add(const app_tsync_sample_t *sample)
+{
+    const app_tsync_sample_t *best = sample;
+
+    s_app_tsync_samples[s_app_tsync_sample_index] = *sample;
+    s_app_tsync_sample_index = (s_app_tsync_sample_index + 1) % APP_TSYNC_FILTER_LEN;
+    if(s_app_tsync_sample_count < APP_TSYNC_FILTER_LEN) {
+        s_app_tsync_sample_count++;
+    }
+
+    for(uint8_t i = 0; i < s_app_tsync_sample_count; i++) {
+        if(s_app_tsync_samples[i].delay < best->delay) {
+            best = &s_app_tsync_samples[i];
+        }
+    }
+
+    // carry older best sample forward to now with current drift
+    int64_t offset = best->offset + ((sample->local_time - best->local_time) * s_app_tsync_drift) / 1000000000LL;
+    app_tsync_estimate_set(offset, best->delay, sample->local_time);
+}
+
+/** @} */ // End of app_tsync_static_funcs group
+
+/**
+ * @addtogroup app_tsync_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize peer clock synchronization and start periodic exchanges
+ *
+ */
+void app_tsync_init(void)
+{
+    xSemaphoreTsync = xSemaphoreCreateMutex();
+    xTaskCreate(app_tsync_task, "app_tsync_task", 2048, NULL, 2, NULL);
+}
+
+/**
+ * @brief handles time sync frame received from peer
+ *
+ * @param session link session of peer
+ * @param time_sync received time sync frame
+ * @param rx_time local time the frame was received
+ */
+void app_tsync_received(uint8_t session, const time_sync_t time_sync, int64_t rx_time)
+{
+    if(xSemaphoreTsync == NULL) {
+        return;
+    }
+
+    if(!time_sync.reply) {
+        time_sync_t reply;
+        memcpy(&reply, &time_sync, sizeof(reply));
+        reply.reply = 1;
+        reply.t2 = rx_time;
+        reply.tsf_base = app_tsync_tsf_base_get();
+        app_link_time_sync_send(session, &reply);
+        return;
+    }
+
+    // ignore late responses to earlier requests, requests only go to the default peer
+    if(session != APP_LINK_SESSION_DEFAULT || time_sync.seq != s_app_tsync_seq) {
+        return;
+    }
+
+    if(xSemaphoreTake(xSemaphoreTsync, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    int64_t local_tsf_base = app_tsync_tsf_base_get();
+    if(time_sync.tsf_base != 0 && local_tsf_base != 0) {
+        // both clocks are tied to the same TSF, no path delay to estimate
+        app_tsync_estimate_set(time_sync.tsf_base - local_tsf_base, 0, rx_time);
+    } else {
+        app_tsync_sample_t sample;
+        sample.offset = ((time_sync.t2 - time_sync.t1) + (time_sync.t3 - rx_time)) / 2;
+        sample.delay = (rx_time - time_sync.t1) - (time_sync.t3 - time_sync.t2);
+        sample.local_time = rx_time;
+        app_tsync_sample_add(&sample);
+    }
+    xSemaphoreGive(xSemaphoreTsync);
+}
+
+/**
+ * @brief checks if an offset estimate is available
+ *
+ * @return true once first exchange with peer has completed
+ */
+bool app_tsync_is_synced(void)
+{
+    return s_app_tsync_synced;
+}
+
+/**
+ * @brief offset of peer clock to local clock at current time, corrected for drift
+ *
+ * @return peer clock minus local clock in microseconds
+ */
+int64_t app_tsync_offset_get(void)
+{
+    int64_t offset = 0;
+
+    if(xSemaphoreTsync == NULL || xSemaphoreTake(xSemaphoreTsync, portMAX_DELAY) != pdTRUE) {
+        return 0;
+    }
+    offset = s_app_tsync_offset + ((esp_timer_get_time() - s_app_tsync_ref_time) * s_app_tsync_drift) / 1000000000LL;
+    xSemaphoreGive(xSemaphoreTsync);
+    return offset;
+}
+
+/**
+ * @brief current time on peer esp_timer clock
+ *
+ * @return peer time in microseconds
+ */
+int64_t app_tsync_peer_time_get(void)
+{
+    return esp_timer_get_time() + app_tsync_offset_get();
+}
+
+/**
+ * @brief converts a peer clock timestamp to local clock
+ *
+ * @param peer_time peer time in microseconds
+ * @return local time in microseconds
+ */
+int64_t app_tsync_to_local(int64_t peer_time)
+{
+    return peer_time - app_tsync_offset_get();
+}
+
+/**
+ * @brief rate of peer clock relative to local clock
+ *
+ * @return drift in parts per billion
+ */
+int32_t app_tsync_drift_get(void)
+{
+    return s_app_tsync_drift;
+}
+
+/**
+ * @brief round trip time of exchange the current estimate is based on
+ *
+ * @return round trip time in microseconds, 0 when estimate is from Wi-Fi TSF
+ */
+int64_t app_tsync_delay_get(void)
+{
+    return s_app_tsync_delay;
+}
+
+/** @} */ // End of app_tsync_global_funcs group
+
+/** @} */ // End of app_tsync group
+
+/** @} */ // End of app_tsync module
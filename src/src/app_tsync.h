@@ -0,0 +1,141 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_tsync.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application peer clock synchronization header
+ */
+
+#ifndef APP_TSYNC_H
+#define APP_TSYNC_H
+
+/**
+ * @defgroup app_tsync Application peer clock synchronization Module
+ * @brief Module for estimating offset and drift between local and peer esp_timer clocks
+ * @{
+ */
+
+/**
+ * @addtogroup app_tsync_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "commons.h"
+/** @} */ // End of app_tsync_include group
+
+/**
+ * @addtogroup app_tsync_define
+ * @{
+ */
+
+/* number of recent exchanges the offset estimate is picked from */
+#define APP_TSYNC_FILTER_LEN    8
+
+/** @} */ // End of app_tsync_define group
+
+/**
+ * @addtogroup app_tsync_types
+ * @{
+ */
+
+/* one completed request and response exchange */
+typedef struct {
+    int64_t offset;         /**< peer clock minus local clock in microseconds */
+    int64_t delay;          /**< round trip time excluding peer turnaround in microseconds */
+    int64_t local_time;     /**< local time the exchange completed */
+} app_tsync_sample_t;
+
+/** @} */ // End of app_tsync_types group
+
+/**
+ * @addtogroup app_tsync_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize peer clock synchronization and start periodic exchanges
+ *
+ */
+void app_tsync_init(void);
+
+/**
+ * @brief handles time sync frame received from peer
+ *
+ * @param session link session of peer
+ * @param time_sync received time sync frame
+ * @param rx_time local time the frame was received
+ */
+void app_tsync_received(uint8_t session, const time_sync_t time_sync, int64_t rx_time);
+
+/**
+ * @brief checks if an offset estimate is available
+ *
+ * @return true once first exchange with peer has completed
+ */
+bool app_tsync_is_synced(void);
+
+/**
+ * @brief offset of peer clock to local clock at current time, corrected for drift
+ *
+ * @return peer clock minus local clock in microseconds
+ */
+int64_t app_tsync_offset_get(void);
+
+/**
+ * @brief current time on peer esp_timer clock
+ *
+ * @return peer time in microseconds
+ */
+int64_t app_tsync_peer_time_get(void);
+
+/**
+ * @brief converts a peer clock timestamp to local clock
+ *
+ * @param peer_time peer time in microseconds
+ * @return local time in microseconds
+ */
+int64_t app_tsync_to_local(int64_t peer_time);
+
+/**
+ * @brief rate of peer clock relative to local clock
+ *
+ * @return drift in parts per billion
+ */
+int32_t app_tsync_drift_get(void);
+
+/**
+ * @brief round trip time of exchange the current estimate is based on
+ *
+ * @return round trip time in microseconds, 0 when estimate is from Wi-Fi TSF
+ */
+int64_t app_tsync_delay_get(void);
+
+/** @} */ // End of app_tsync_global_funcs group
+
+/** @} */ // End of app_tsync group
+
+#endif
@@ -40,7 +40,9 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -52,9 +54,11 @@
 #include "config.h"
 #include "commons.h"
 #include "led.h"
-#include "app_espnow.h"
+#include "app_link.h"
 #include "app_conn.h"
 #include "app_tusb.h"
+#include "app_tusb_mux.h"
+#include "app_tsync.h"
 
 /** @} */ // End of app_tusb_include group
 
@@ -68,6 +72,26 @@
 #define APP_TUSB_CDC_TX_BUFSIZE CONFIG_TINYUSB_CDC_TX_BUFSIZE
 #define APP_TUSB_CDC_DEFAULT_BITRATE    9600
 
+/* longest wait for host data received before a line coding change to be queued to link */
+#define APP_TUSB_CONFIG_DRAIN_MS        20
+
+/* one cdc port per peer, port index is link session index, remaining peers go over the multiplexer */
+#if APP_TUSB_MUX_ENABLE && (APP_LINK_SESSION_COUNT > CONFIG_TINYUSB_CDC_COUNT)
+#define APP_TUSB_PORT_COUNT             CONFIG_TINYUSB_CDC_COUNT
+#else
+#define APP_TUSB_PORT_COUNT             APP_LINK_SESSION_COUNT
+#endif
+
+#if APP_TUSB_PORT_COUNT > CONFIG_TINYUSB_CDC_COUNT
+#error Each peer needs its own CDC port, raise CONFIG_TINYUSB_CDC_COUNT, enable CONFIG_USB_MUX_ENABLE or lower CONFIG_LINK_PEER_COUNT!
+#endif
+
+#define APP_TUSB_SERIAL_STATE_ENABLE    CONFIG_SERIAL_STATE_ENABLE
+/* carrier detect drops after this long without serial state from peer, in microseconds */
+#define APP_TUSB_SERIAL_STATE_TIMEOUT_US    (3 * CONFIG_SERIAL_STATE_PERIOD_MS * 1000LL)
+/* interval of carrier checks and retries of a notification the endpoint was busy for, in milliseconds */
+#define APP_TUSB_SERIAL_STATE_POLL_MS   50
+
 /** @} */ // End of app_tusb_define group
 
 /**
@@ -75,18 +99,16 @@
  * @{
  */
 static const char *TAG = "app_tusb";
-static config_settings_t s_app_config_settings = {
-    .bitrate = APP_TUSB_CDC_DEFAULT_BITRATE,
-    .data_bits = 8,
-    .parity = 0,
-    .stop_bits = 0,
-    .hw_flow_status = APP_TUSB_HW_FLOW_DISABLE
-};
+
+static app_tusb_port_t s_app_tusb_ports[APP_TUSB_PORT_COUNT];
 
 static QueueHandle_t s_app_tusb_config_queue;
 
-static int last_dtr = APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN;
-static int last_rts = APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN;
+#if APP_TUSB_SERIAL_STATE_ENABLE
+/* guards serial state of ports between link task and serial state task */
+static portMUX_TYPE s_app_tusb_serial_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_app_tusb_serial_state_task_handle = NULL;
+#endif
 
 /** @} */ // End of app_tusb_static_vars group
 
@@ -97,8 +119,8 @@ static int last_rts = APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN;
 size_t usb_rx_size = 0;
 uint32_t bit_rate_last=APP_TUSB_CDC_DEFAULT_BITRATE;
 uint8_t app_tusb_hw_flow_status = APP_TUSB_HW_FLOW_DISABLE;
+uint8_t app_tusb_sw_flow_status = CONFIG_UART_SW_FLOW_ENABLE;
 
-SemaphoreHandle_t xSemaphoreUsbRead = NULL;
 uint8_t evt_rx = APP_TUSB_TYPE_DATA;
 app_tusb_data_t evt;
 /** @} */ // End of app_tusb_global_vars group
@@ -111,8 +133,16 @@ static void app_tusb_cdc_rx_callback(int itf, cdcacm_event_t *event);
 static void app_tusb_cdc_line_state_changed_callback(int itf, cdcacm_event_t *event);
 static void app_tusb_cdc_line_coding_changed_callback(int itf, cdcacm_event_t *event);
 static void app_tusb_data_read_task(void *pvParameter);
-static void app_tusb_read();
-static void app_tusb_config_hw_line_update(void);
+static void app_tusb_read(uint8_t itf);
+static void app_tusb_config_hw_line_update(uint8_t itf);
+static void app_tusb_rx_drain_wait(uint8_t itf);
+static void app_tusb_config_hw_flow_send(void);
+#if APP_TUSB_SERIAL_STATE_ENABLE
+static void app_tusb_serial_state_task(void *pvParameter);
+#endif
+#if CONFIG_STATS_LOG_PERIOD_MS
+static void app_tusb_stats_task(void *pvParameter);
+#endif
 /** @} */ // End of app_tusb_static_funcs group
 
 /**
@@ -128,7 +158,7 @@ static void app_tusb_config_hw_line_update(void);
  */
 static void IRAM_ATTR app_tusb_cdc_rx_callback(int itf, cdcacm_event_t *event)
 {
-    xSemaphoreGive(xSemaphoreUsbRead);
+    xSemaphoreGive(s_app_tusb_ports[itf].read);
 }
 
 /**
@@ -139,19 +169,21 @@ static void IRAM_ATTR app_tusb_cdc_rx_callback(int itf, cdcacm_event_t *event)
  */
 static void app_tusb_cdc_line_state_changed_callback(int itf, cdcacm_event_t *event)
 {
-    ESP_LOGE(TAG, "DTR: %d, RTS: %d", event->line_state_changed_data.dtr, event->line_state_changed_data.rts);
+    ESP_LOGE(TAG, "DTR: %d, RTS: %d on channel %d", event->line_state_changed_data.dtr, event->line_state_changed_data.rts, itf);
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
     app_tusb_evt_config_t evt;
 
     int dtr = event->line_state_changed_data.dtr;
     int rts = event->line_state_changed_data.rts;
     
-    if(last_dtr != dtr || last_rts != rts) {
-        last_dtr = dtr;
+    if(port->last_dtr != dtr || port->last_rts != rts) {
+        port->last_dtr = dtr;
         evt.config_hw_line.dtr = dtr;
 
-        last_rts = rts;
+        port->last_rts = rts;
         evt.config_hw_line.rts = rts;
         evt.type = APP_TUSB_TYPE_DTR_RTS;
+        evt.itf = itf;
 
         if (xQueueSend(s_app_tusb_config_queue, &evt, 0) != pdTRUE) {
             ESP_LOGW(TAG, "Send dtr queue fail");
@@ -173,11 +205,13 @@ static void app_tusb_cdc_line_coding_changed_callback(int itf, cdcacm_event_t *e
     ESP_LOGE(TAG, "Line state changed on channel %d: bit_rate:%lu", itf, bit_rate);
 
     evt.type = APP_TUSB_TYPE_CONFIG;
+    evt.itf = itf;
     evt.config_settings.bitrate = bit_rate;
     evt.config_settings.data_bits = event->line_coding_changed_data.p_line_coding->data_bits;
     evt.config_settings.parity = event->line_coding_changed_data.p_line_coding->parity;
     evt.config_settings.stop_bits = event->line_coding_changed_data.p_line_coding->stop_bits;
     evt.config_settings.hw_flow_status = app_tusb_hw_flow_status;
+    evt.config_settings.sw_flow_status = app_tusb_sw_flow_status;
     // evt.config_settings.hw_flow_status = APP_TUSB_HW_FLOW_DISABLE;
 
     if (xQueueSend(s_app_tusb_config_queue, &evt, 0) != pdTRUE) {
@@ -186,18 +220,21 @@ static void app_tusb_cdc_line_coding_changed_callback(int itf, cdcacm_event_t *e
 }
 
 /**
- * @brief receives data over usb cdc and sends data over espnow
+ * @brief receives data over usb cdc and sends data to peer
+ * @param itf cdc port, same index as link session of peer
  * 
  */
-static void IRAM_ATTR app_tusb_read(void)
+static void IRAM_ATTR app_tusb_read(uint8_t itf)
 {
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
     size_t rx_size = 0;
+    port->read_busy = true;
     uint8_t *buf = pvPortMalloc(APP_TUSB_CDC_RX_BUFSIZE);
     /* read */
-    esp_err_t ret = tinyusb_cdcacm_read(TINYUSB_CDC_ACM_0, buf, CONFIG_TINYUSB_CDC_RX_BUFSIZE, &rx_size);
+    esp_err_t ret = tinyusb_cdcacm_read(itf, buf, CONFIG_TINYUSB_CDC_RX_BUFSIZE, &rx_size);
     if (ret == ESP_OK && rx_size != 0) {
         usb_rx_size = usb_rx_size + rx_size;
-        // ESP_LOGI(TAG, "Data from channel %d:", TINYUSB_CDC_ACM_0);
+        // ESP_LOGI(TAG, "Data from channel %d:", itf);
         // ESP_LOG_BUFFER_HEXDUMP(TAG, buf, rx_size, ESP_LOG_INFO);
         // ESP_LOGE(TAG, "%u, %u", rx_size, usb_rx_size);
 
@@ -205,25 +242,50 @@ static void IRAM_ATTR app_tusb_read(void)
         evt.data = buf;
         evt.len = rx_size;  
 
-        app_espnow_data_send(buf, rx_size);
+        app_link_data_send(itf, buf, rx_size);
     } else {
         ESP_LOGI(TAG, "Read error");
     }
     vPortFree(buf);
+    port->read_busy = false;
 }
 
 /**
- * @brief task which receives data over usb cdc
- * @param pvParameter task arguments
+ * @brief waits until host data received before now is queued to link, so config settings follow it in the stream
+ * @param itf cdc port, same index as link session of peer
+ * 
+ */
+static void app_tusb_rx_drain_wait(uint8_t itf)
+{
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
+    TickType_t start = xTaskGetTickCount();
+    while(port->read_busy || uxSemaphoreGetCount(port->read) != 0 || tud_cdc_n_available(itf) != 0) {
+        if((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(APP_TUSB_CONFIG_DRAIN_MS)) {
+            ESP_LOGE(TAG, "config sent before host data drained");
+            break;
+        }
+        vTaskDelay(1);
+    }
+}
+
+/**
+ * @brief task which receives data over one usb cdc port
+ * @param pvParameter cdc port index
  * 
  */
 static void IRAM_ATTR app_tusb_data_read_task(void *pvParameter)
 {
+    uint8_t itf = (uint8_t)(uintptr_t)pvParameter;
     uint8_t evt = APP_TUSB_TYPE_DATA;
-    while(xSemaphoreTake(xSemaphoreUsbRead, portMAX_DELAY)) {    
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
+    while(xSemaphoreTake(port->read, portMAX_DELAY)) {    
+        // host data stays in cdc, so host is held off once its buffer fills
+        while(port->peer_xoff) {
+            xSemaphoreTake(port->peer_xon, pdMS_TO_TICKS(100));
+        }
         switch(evt) {
             case APP_TUSB_TYPE_DATA: {
-                app_tusb_read();
+                app_tusb_read(itf);
             } break;
             default: {
 
@@ -244,13 +306,13 @@ static void app_tusb_config_task(void *pvParameter)
     while (xQueueReceive(s_app_tusb_config_queue, &evt, portMAX_DELAY) == pdTRUE) {
         switch(evt.type) {
             case APP_TUSB_TYPE_CONFIG: {
-                memcpy(&s_app_config_settings, &evt.config_settings, sizeof(s_app_config_settings));
-                app_espnow_send_timeout = (uint32_t)((APP_ESPNOW_SEND_DATA_SIZE*8*1000)/s_app_config_settings.bitrate) + (uint32_t)(1000/s_app_config_settings.bitrate) + 20;
-                ESP_LOGE(TAG, "app_espnow_send_timeout: %lu", app_espnow_send_timeout);
-                app_espnow_config_settings_send(evt.config_settings);
+                memcpy(&s_app_tusb_ports[evt.itf].config_settings, &evt.config_settings, sizeof(evt.config_settings));
+                app_link_send_timeout_update(evt.itf, evt.config_settings.bitrate);
+                app_tusb_rx_drain_wait(evt.itf);
+                app_link_config_settings_send(evt.itf, evt.config_settings);
             } break;
             case APP_TUSB_TYPE_DTR_RTS: {
-                app_espnow_config_hw_line_send(evt.config_hw_line);
+                app_link_config_hw_line_send(evt.itf, evt.config_hw_line);
             } break;
             default: {
 
@@ -261,19 +323,99 @@ static void app_tusb_config_task(void *pvParameter)
 }
 
 /**
- * @brief sends updated state of hardware lines over espnow
+ * @brief sends updated state of hardware lines of a cdc port to its peer
+ * @param itf cdc port, same index as link session of peer
  * 
  */
-static void app_tusb_config_hw_line_update(void)
+static void app_tusb_config_hw_line_update(uint8_t itf)
 {
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
     config_hw_line_t config_hw_line;
-    if(last_dtr != APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN && last_rts != APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN) {
-        config_hw_line.dtr = last_dtr;
-        config_hw_line.rts = last_rts;
+    if(port->last_dtr != APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN && port->last_rts != APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN) {
+        config_hw_line.dtr = port->last_dtr;
+        config_hw_line.rts = port->last_rts;
+
+        app_link_config_hw_line_send(itf, config_hw_line);
+    }
+}
+
+/**
+ * @brief sends hardware flow control state to all peers
+ * 
+ */
+static void app_tusb_config_hw_flow_send(void)
+{
+    for(uint8_t itf = 0; itf < APP_TUSB_PORT_COUNT; itf++) {
+        s_app_tusb_ports[itf].config_settings.hw_flow_status = app_tusb_hw_flow_status;
+        app_link_config_settings_send(itf, s_app_tusb_ports[itf].config_settings);
+    }
+}
 
-        app_espnow_config_hw_line_send(config_hw_line);
+#if APP_TUSB_SERIAL_STATE_ENABLE
+/**
+ * @brief task which raises SERIAL_STATE notifications, with carrier detect up while peers send serial state
+ * @param pvParameter task arguments
+ * 
+ */
+static void app_tusb_serial_state_task(void *pvParameter)
+{
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(APP_TUSB_SERIAL_STATE_POLL_MS));
+        int64_t now = esp_timer_get_time();
+
+        for(uint8_t itf = 0; itf < APP_TUSB_PORT_COUNT; itf++) {
+            app_tusb_port_t *port = &s_app_tusb_ports[itf];
+
+            portENTER_CRITICAL(&s_app_tusb_serial_lock);
+            uint16_t errors = port->serial_errors;
+            int64_t time = port->serial_state_time;
+            portEXIT_CRITICAL(&s_app_tusb_serial_lock);
+
+            uint16_t state = (time != 0 && (now - time) < APP_TUSB_SERIAL_STATE_TIMEOUT_US) ? (SERIAL_STATE_DCD | SERIAL_STATE_DSR) : 0;
+            if(state == port->serial_stats.state && errors == 0) {
+                continue;
+            }
+            // errors are one shot bits, carrier is sent with every notification
+            if(!tud_cdc_n_send_serial_state(itf, state | errors)) {
+                continue;
+            }
+            portENTER_CRITICAL(&s_app_tusb_serial_lock);
+            port->serial_errors &= ~errors;
+            portEXIT_CRITICAL(&s_app_tusb_serial_lock);
+            if(state != port->serial_stats.state) {
+                ESP_LOGI(TAG, "carrier %s on channel %d", state ? "up" : "lost", itf);
+                port->serial_stats.state = state;
+            }
+        }
     }
 }
+#endif
+
+#if CONFIG_STATS_LOG_PERIOD_MS
+/**
+ * @brief task which logs XON/XOFF and serial state statistics of each cdc port periodically
+ * @param pvParameter task arguments
+ * 
+ */
+static void app_tusb_stats_task(void *pvParameter)
+{
+    app_tusb_flow_stats_t flow_stats;
+    app_tusb_serial_stats_t serial_stats;
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_STATS_LOG_PERIOD_MS));
+        for(uint8_t itf = 0; itf < APP_TUSB_PORT_COUNT; itf++) {
+            app_tusb_flow_stats_get(itf, &flow_stats);
+            ESP_LOGI(TAG, "channel %d xoffs: %lu, xoff latency: %lu us last, %lu us max", itf,
+                     (unsigned long)flow_stats.xoffs, (unsigned long)flow_stats.latency_us_last, (unsigned long)flow_stats.latency_us_max);
+            app_tusb_serial_stats_get(itf, &serial_stats);
+            ESP_LOGI(TAG, "channel %d carrier: %s, cts: %u, breaks: %lu, parity errors: %lu, frame errors: %lu, overruns: %lu", itf,
+                     serial_stats.state ? "up" : "lost", serial_stats.cts, (unsigned long)serial_stats.breaks,
+                     (unsigned long)serial_stats.parity_errors, (unsigned long)serial_stats.frame_errors, (unsigned long)serial_stats.overruns);
+        }
+    }
+}
+#endif
 
 /** @} */ // End of app_tusb_static_funcs group
 
@@ -290,17 +432,40 @@ int app_tusb_init(void)
 {
     ESP_LOGI(TAG, "USB initialization");
 
-    xSemaphoreUsbRead = xSemaphoreCreateCounting(80, 0);
-    xSemaphoreGive(xSemaphoreUsbRead);
+    for(uint8_t itf = 0; itf < APP_TUSB_PORT_COUNT; itf++) {
+        app_tusb_port_t *port = &s_app_tusb_ports[itf];
+        port->config_settings.bitrate = APP_TUSB_CDC_DEFAULT_BITRATE;
+        port->config_settings.data_bits = 8;
+        port->config_settings.parity = 0;
+        port->config_settings.stop_bits = 0;
+        port->config_settings.hw_flow_status = APP_TUSB_HW_FLOW_DISABLE;
+        port->config_settings.sw_flow_status = app_tusb_sw_flow_status;
+        port->peer_xoff = false;
+        port->peer_xon = xSemaphoreCreateBinary();
+        port->serial_errors = 0;
+        port->serial_state_time = 0;
+        port->last_dtr = APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN;
+        port->last_rts = APP_TUSB_HW_FLOW_LINE_STATE_UNKNOWN;
+        port->read = xSemaphoreCreateCounting(80, 0);
+        xSemaphoreGive(port->read);
+    }
 
-    s_app_tusb_config_queue = xQueueCreate(APP_ESPNOW_QUEUE_SIZE, sizeof(app_tusb_evt_config_t));
+    s_app_tusb_config_queue = xQueueCreate(APP_LINK_QUEUE_SIZE, sizeof(app_tusb_evt_config_t));
     if (s_app_tusb_config_queue == NULL) {
         ESP_LOGE(TAG, "Create mutex fail");
         return ESP_FAIL;
     }
 
-    xTaskCreate(app_tusb_data_read_task, "app_tusb_read_task", 4096, NULL, 3, NULL);
+    for(uint8_t itf = 0; itf < APP_TUSB_PORT_COUNT; itf++) {
+        xTaskCreate(app_tusb_data_read_task, "app_tusb_read_task", 4096, (void *)(uintptr_t)itf, 3, NULL);
+    }
     xTaskCreate(app_tusb_config_task, "app_tusb_config_task", 2048, NULL, 6, NULL);
+#if APP_TUSB_SERIAL_STATE_ENABLE
+    xTaskCreate(app_tusb_serial_state_task, "app_tusb_serial_state_task", 2048, NULL, 5, &s_app_tusb_serial_state_task_handle);
+#endif
+#if CONFIG_STATS_LOG_PERIOD_MS
+    xTaskCreate(app_tusb_stats_task, "app_tusb_stats_task", 2048, NULL, 1, NULL);
+#endif
 
     const tinyusb_config_t tusb_cfg = {
         .string_descriptor = NULL,
@@ -308,6 +473,9 @@ int app_tusb_init(void)
     };
 
     ESP_ERROR_CHECK(tinyusb_driver_install(&tusb_cfg));
+#if APP_TUSB_MUX_ENABLE
+    ESP_ERROR_CHECK(app_tusb_mux_init(APP_TUSB_PORT_COUNT));
+#endif
 
     tinyusb_config_cdcacm_t acm_cfg = {
         .usb_dev = TINYUSB_USBDEV_0,
@@ -319,21 +487,15 @@ int app_tusb_init(void)
         .callback_line_coding_changed = &app_tusb_cdc_line_coding_changed_callback   
     };
 
-    ESP_ERROR_CHECK(tusb_cdc_acm_init(&acm_cfg));
-    /* the second way to register a callback */
-    ESP_ERROR_CHECK(tinyusb_cdcacm_register_callback(
-                        TINYUSB_CDC_ACM_0,
-                        CDC_EVENT_LINE_STATE_CHANGED,
-                        &app_tusb_cdc_line_state_changed_callback));
-
-#if (CONFIG_TINYUSB_CDC_COUNT > 1)
-    acm_cfg.cdc_port = TINYUSB_CDC_ACM_1;
-    ESP_ERROR_CHECK(tusb_cdc_acm_init(&acm_cfg));
-    ESP_ERROR_CHECK(tinyusb_cdcacm_register_callback(
-                        TINYUSB_CDC_ACM_1,
-                        CDC_EVENT_LINE_STATE_CHANGED,
-                        &tinyusb_cdc_line_state_changed_callback));
-#endif
+    for(uint8_t itf = 0; itf < APP_TUSB_PORT_COUNT; itf++) {
+        acm_cfg.cdc_port = (tinyusb_cdcacm_itf_t)itf;
+        ESP_ERROR_CHECK(tusb_cdc_acm_init(&acm_cfg));
+        /* the second way to register a callback */
+        ESP_ERROR_CHECK(tinyusb_cdcacm_register_callback(
+                            (tinyusb_cdcacm_itf_t)itf,
+                            CDC_EVENT_LINE_STATE_CHANGED,
+                            &app_tusb_cdc_line_state_changed_callback));
+    }
 
     ESP_LOGI(TAG, "USB initialization DONE");
 
@@ -342,17 +504,24 @@ int app_tusb_init(void)
 
 /**
  * @brief write to device over usb cdc
+ * @param itf cdc port, same index as link session of peer
  * @param tx_buf transmit buffer
  * @param tx_size buffer size
  * 
  */
-void IRAM_ATTR app_tusb_write(const uint8_t *tx_buf, size_t tx_size)
+void IRAM_ATTR app_tusb_write(uint8_t itf, const uint8_t *tx_buf, size_t tx_size)
 {
+#if APP_TUSB_MUX_ENABLE
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        app_tusb_mux_write(itf, tx_buf, tx_size);
+        return;
+    }
+#endif
     /* write */
     size_t tx_len = tx_size;
     do {
-        int tx_bytes = tinyusb_cdcacm_write_queue(TINYUSB_CDC_ACM_0, &tx_buf[tx_size-tx_len], tx_len);
-        tinyusb_cdcacm_write_flush(TINYUSB_CDC_ACM_0, 0);
+        int tx_bytes = tinyusb_cdcacm_write_queue(itf, &tx_buf[tx_size-tx_len], tx_len);
+        tinyusb_cdcacm_write_flush(itf, 0);
         tx_len = tx_len - tx_bytes;
         if(tx_len != 0) {
             taskYIELD();
@@ -361,31 +530,41 @@ void IRAM_ATTR app_tusb_write(const uint8_t *tx_buf, size_t tx_size)
 }
 
 /**
- * @brief sends serial connection configuration over espnow
+ * @brief sends serial connection configuration of a cdc port to its peer
+ * @param itf cdc port, same index as link session of peer
  * 
  */
-void app_tusb_config_request (void) {
-    app_espnow_config_settings_send(s_app_config_settings);
+void app_tusb_config_request (uint8_t itf) {
+#if APP_TUSB_MUX_ENABLE
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        app_tusb_mux_config_request(itf);
+        return;
+    }
+#endif
+    // peer restarted, an XOFF of its target from before is void
+    if(s_app_tusb_ports[itf].peer_xoff) {
+        s_app_tusb_ports[itf].peer_xoff = false;
+        xSemaphoreGive(s_app_tusb_ports[itf].peer_xon);
+    }
+    app_link_config_settings_send(itf, s_app_tusb_ports[itf].config_settings);
 }
 
 /**
- * @brief sends event of enabling hardware flow control over espnow
+ * @brief sends event of enabling hardware flow control to peers
  * 
  */
 void app_tusb_config_hw_flow_enable (void) {
     app_tusb_hw_flow_status = APP_TUSB_HW_FLOW_ENABLE;
-    s_app_config_settings.hw_flow_status = app_tusb_hw_flow_status;
-    app_espnow_config_settings_send(s_app_config_settings);
+    app_tusb_config_hw_flow_send();
 }
 
 /**
- * @brief sends event of disabling hardware flow control over espnow
+ * @brief sends event of disabling hardware flow control to peers
  * 
  */
 void app_tusb_config_hw_flow_disble (void) {
     app_tusb_hw_flow_status = APP_TUSB_HW_FLOW_DISABLE;
-    s_app_config_settings.hw_flow_status = app_tusb_hw_flow_status;
-    app_espnow_config_settings_send(s_app_config_settings);
+    app_tusb_config_hw_flow_send();
 }
 
 /**
@@ -396,13 +575,153 @@ void app_tusb_config_hw_flow_toggle (void) {
     if(app_tusb_hw_flow_status == APP_TUSB_HW_FLOW_ENABLE) {
         app_tusb_config_hw_flow_disble();
         app_conn_on(HW_FLOW_DIS_CONN_ON_PERIOD, HW_FLOW_DIS_CONN_OFF_PERIOD, HW_FLOW_DIS_APP_CONN_ON_COUNT);
-        app_tusb_config_hw_line_update();
+        for(uint8_t itf = 0; itf < APP_TUSB_PORT_COUNT; itf++) {
+            app_tusb_config_hw_line_update(itf);
+        }
     } else {
         app_tusb_config_hw_flow_enable();
         app_conn_on(HW_FLOW_EN_CONN_ON_PERIOD, HW_FLOW_EN_CONN_OFF_PERIOD, HW_FLOW_EN_APP_CONN_ON_COUNT);
     }
 }
 
+/**
+ * @brief holds host data of a cdc port while target of its peer sent XOFF
+ * @param itf cdc port, same index as link session of peer
+ * @param flow_ctrl XON/XOFF state of target
+ * 
+ */
+void app_tusb_flow_ctrl_received(uint8_t itf, const flow_ctrl_t flow_ctrl)
+{
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        // multiplexed streams are held off by their credit
+        return;
+    }
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
+    if(flow_ctrl.xoff) {
+        port->peer_xoff = true;
+        port->flow_stats.xoffs++;
+        port->flow_stats.latency_us_last = 0;
+        // target time is on peer clock, only the default peer is synchronized
+        if(flow_ctrl.time != 0 && itf == APP_LINK_SESSION_DEFAULT && app_tsync_is_synced()) {
+            int64_t latency = esp_timer_get_time() - app_tsync_to_local(flow_ctrl.time);
+            if(latency > 0) {
+                port->flow_stats.latency_us_last = (uint32_t)latency;
+                if(port->flow_stats.latency_us_last > port->flow_stats.latency_us_max) {
+                    port->flow_stats.latency_us_max = port->flow_stats.latency_us_last;
+                }
+            }
+        }
+        ESP_LOGI(TAG, "target XOFF on channel %d, latency %lu us", itf, (unsigned long)port->flow_stats.latency_us_last);
+    } else if(port->peer_xoff) {
+        port->peer_xoff = false;
+        xSemaphoreGive(port->peer_xon);
+    }
+}
+
+/**
+ * @brief XON/XOFF statistics of a cdc port
+ * @param itf cdc port, same index as link session of peer
+ * @param stats XON/XOFF statistics
+ * 
+ */
+void app_tusb_flow_stats_get(uint8_t itf, app_tusb_flow_stats_t *stats)
+{
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = s_app_tusb_ports[itf].flow_stats;
+}
+
+/**
+ * @brief passes UART errors of target behind the peer of a cdc port to host, and keeps carrier detect up
+ * @param itf cdc port, same index as link session of peer
+ * @param serial_state UART errors and line state of target
+ * 
+ */
+void app_tusb_serial_state_received(uint8_t itf, const serial_state_t serial_state)
+{
+#if APP_TUSB_SERIAL_STATE_ENABLE
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        // multiplexed streams have no notification endpoint
+        return;
+    }
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
+    uint16_t errors = serial_state.errors & SERIAL_STATE_ERRORS;
+
+    port->serial_stats.cts = serial_state.cts;
+    port->serial_stats.breaks += (errors & SERIAL_STATE_BREAK) ? 1 : 0;
+    port->serial_stats.parity_errors += (errors & SERIAL_STATE_PARITY) ? 1 : 0;
+    port->serial_stats.frame_errors += (errors & SERIAL_STATE_FRAMING) ? 1 : 0;
+    port->serial_stats.overruns += (errors & SERIAL_STATE_OVERRUN) ? 1 : 0;
+
+    portENTER_CRITICAL(&s_app_tusb_serial_lock);
+    port->serial_errors |= errors;
+    port->serial_state_time = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_app_tusb_serial_lock);
+
+    // carrier loss is found by the task polling, errors and carrier coming up are raised right away
+    if(errors != 0 || port->serial_stats.state == 0) {
+        xTaskNotifyGive(s_app_tusb_serial_state_task_handle);
+    }
+#endif
+}
+
+/**
+ * @brief serial state statistics of a cdc port
+ * @param itf cdc port, same index as link session of peer
+ * @param stats serial state statistics
+ * 
+ */
+void app_tusb_serial_stats_get(uint8_t itf, app_tusb_serial_stats_t *stats)
+{
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = s_app_tusb_ports[itf].serial_stats;
+}
+
+/**
+ * @brief takes note of bitrate of target detected by peer of a cdc port, and reports it to host as line coding if peer keeps it
+ * @param itf cdc port, same index as link session of peer
+ * @param autobaud detected bitrate
+ * 
+ */
+void app_tusb_autobaud_received(uint8_t itf, const autobaud_t autobaud)
+{
+    ESP_LOGI(TAG, "target bitrate %lu detected on channel %d, measured %lu", (unsigned long)autobaud.bitrate, itf, (unsigned long)autobaud.measured);
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        return;
+    }
+    app_tusb_port_t *port = &s_app_tusb_ports[itf];
+    port->autobaud = autobaud;
+    if(autobaud.override) {
+        // host reading line coding sees bitrate in use, settings sent to peer again keep it
+        cdc_line_coding_t coding;
+        tud_cdc_n_get_line_coding(itf, &coding);
+        coding.bit_rate = autobaud.bitrate;
+        tud_cdc_n_set_line_coding(itf, &coding);
+        port->config_settings.bitrate = autobaud.bitrate;
+        app_link_send_timeout_update(itf, autobaud.bitrate);
+    }
+}
+
+/**
+ * @brief bitrate of target detected by peer of a cdc port
+ * @param itf cdc port, same index as link session of peer
+ * @param autobaud detected bitrate, 0 until detected
+ * 
+ */
+void app_tusb_autobaud_get(uint8_t itf, autobaud_t *autobaud)
+{
+    if(itf >= APP_TUSB_PORT_COUNT) {
+        memset(autobaud, 0, sizeof(*autobaud));
+        return;
+    }
+    *autobaud = s_app_tusb_ports[itf].autobaud;
+}
+
 #endif
 
 /** @} */ // End of app_tusb_global_funcs group
@@ -52,6 +52,14 @@
 
 #if DEVICE_WISER_USB
 
+/**
+ * @addtogroup app_tusb_include
+ * @{
+ */
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+/** @} */ // End of app_tusb_include group
+
 /**
  * @addtogroup app_tusb_types
  * @{
@@ -84,12 +92,46 @@ typedef struct {
 
 typedef struct {
     uint8_t type;
+    uint8_t itf;        /**< cdc port of event, same index as link session of its peer */
     union {
         config_settings_t config_settings;
         config_hw_line_t config_hw_line;
     };
 } app_tusb_evt_config_t;
 
+/* XON/XOFF of target behind the peer of a cdc port, time from target XOFF to host held off needs synchronized clocks */
+typedef struct {
+    uint32_t xoffs;                     /**< XOFF received from target */
+    uint32_t latency_us_last;           /**< target XOFF to host read stopped of last XOFF, 0 if not measured */
+    uint32_t latency_us_max;            /**< longest target XOFF to host read stopped */
+} app_tusb_flow_stats_t;
+
+/* UART errors and line state of target behind the peer of a cdc port */
+typedef struct {
+    uint16_t state;                     /**< SERIAL_STATE_DCD and SERIAL_STATE_DSR last reported to host */
+    uint8_t cts;                        /**< CTS of target, CDC serial state has no bit for it */
+    uint32_t breaks;                    /**< breaks reported by peer */
+    uint32_t parity_errors;             /**< parity errors reported by peer */
+    uint32_t frame_errors;              /**< framing errors reported by peer */
+    uint32_t overruns;                  /**< UART FIFO overflows reported by peer */
+} app_tusb_serial_stats_t;
+
+/* state of one cdc port, serving the peer with the same link session index */
+typedef struct {
+    config_settings_t config_settings;  /**< line coding last set by host */
+    int last_dtr;
+    int last_rts;
+    volatile bool read_busy;            /**< true while a read from cdc is being handed to link */
+    SemaphoreHandle_t read;             /**< given when host data is received */
+    volatile bool peer_xoff;            /**< target sent XOFF, host data is left in cdc until XON */
+    SemaphoreHandle_t peer_xon;         /**< given when target sends XON */
+    app_tusb_flow_stats_t flow_stats;
+    uint16_t serial_errors;             /**< SERIAL_STATE_ERRORS from peer waiting for notification endpoint */
+    int64_t serial_state_time;          /**< esp_timer time of last serial state from peer, 0 if none */
+    app_tusb_serial_stats_t serial_stats;
+    autobaud_t autobaud;                /**< bitrate of target detected by peer, 0 until detected */
+} app_tusb_port_t;
+
 /** @} */ // End of app_tusb_types group
 
 /**
@@ -104,16 +146,18 @@ typedef struct {
 int app_tusb_init(void);
 /**
  * @brief write to device over usb cdc
+ * @param itf cdc port, same index as link session of peer
  * @param tx_buf transmit buffer
  * @param tx_size buffer size
  * 
  */
-void app_tusb_write(const uint8_t *tx_buf, size_t tx_size);
+void app_tusb_write(uint8_t itf, const uint8_t *tx_buf, size_t tx_size);
 /**
- * @brief sends serial connection configuration over espnow
+ * @brief sends serial connection configuration of a cdc port to its peer
+ * @param itf cdc port, same index as link session of peer
  * 
  */
-void app_tusb_config_request (void);
+void app_tusb_config_request (uint8_t itf);
 /**
  * @brief sends event of enabling hardware flow control over espnow
  * 
@@ -129,6 +173,48 @@ void app_tusb_config_hw_flow_disble (void);
  * 
  */
 void app_tusb_config_hw_flow_toggle (void);
+/**
+ * @brief holds host data of a cdc port while target of its peer sent XOFF
+ * @param itf cdc port, same index as link session of peer
+ * @param flow_ctrl XON/XOFF state of target
+ * 
+ */
+void app_tusb_flow_ctrl_received(uint8_t itf, const flow_ctrl_t flow_ctrl);
+/**
+ * @brief XON/XOFF statistics of a cdc port
+ * @param itf cdc port, same index as link session of peer
+ * @param stats XON/XOFF statistics
+ * 
+ */
+void app_tusb_flow_stats_get(uint8_t itf, app_tusb_flow_stats_t *stats);
+/**
+ * @brief passes UART errors of target behind the peer of a cdc port to host, and keeps carrier detect up
+ * @param itf cdc port, same index as link session of peer
+ * @param serial_state UART errors and line state of target
+ * 
+ */
+void app_tusb_serial_state_received(uint8_t itf, const serial_state_t serial_state);
+/**
+ * @brief serial state statistics of a cdc port
+ * @param itf cdc port, same index as link session of peer
+ * @param stats serial state statistics
+ * 
+ */
+void app_tusb_serial_stats_get(uint8_t itf, app_tusb_serial_stats_t *stats);
+/**
+ * @brief takes note of bitrate of target detected by peer of a cdc port, and reports it to host as line coding if peer keeps it
+ * @param itf cdc port, same index as link session of peer
+ * @param autobaud detected bitrate
+ * 
+ */
+void app_tusb_autobaud_received(uint8_t itf, const autobaud_t autobaud);
+/**
+ * @brief bitrate of target detected by peer of a cdc port
+ * @param itf cdc port, same index as link session of peer
+ * @param autobaud detected bitrate, 0 until detected
+ * 
+ */
+void app_tusb_autobaud_get(uint8_t itf, autobaud_t *autobaud);
 
 /** @} */ // End of app_tusb_global_funcs group
 #endif
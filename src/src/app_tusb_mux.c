@@ -0,0 +1,502 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_tusb_mux.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application usb multiplexer module which carries serial streams of many peers over one USB vendor-class interface
+ *
+ * A CDC port needs its own interface, three endpoints and a host driver instance, so the
+ * ESP32-S2 runs out of endpoints after two ports. The multiplexer carries every peer
+ * without a CDC port over one bulk IN/OUT pair. Frames are tagged with the link session
+ * of their peer (the stream) and never stall each other: host data of a stream is only
+ * accepted up to a credit limit that fits the retransmit buffer of its link session.
+ */
+
+/**
+ * @defgroup app_tusb_mux Application usb multiplexer Module
+ * @brief Module for carrying serial streams of many peers over one USB vendor-class interface
+ * @{
+ */
+
+/**
+ * @addtogroup app_tusb_mux_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "tinyusb.h"
+#include "config.h"
+#include "commons.h"
+#include "app_link.h"
+#include "app_txpwr.h"
+#include "app_tusb.h"
+#include "app_tusb_mux.h"
+
+/** @} */ // End of app_tusb_mux_include group
+
+#if APP_TUSB_MUX_ENABLE
+
+/**
+ * @addtogroup app_tusb_mux_define
+ * @{
+ */
+
+#if !CONFIG_TINYUSB_VENDOR_ENABLED
+#error USB multiplexer needs CONFIG_TINYUSB_VENDOR_ENABLED in sdkconfig!
+#endif
+#if CONFIG_TINYUSB_CDC_COUNT > 1
+#error ESP32-S2 has no IN endpoint left for the vendor-class interface next to two CDC ports!
+#endif
+
+/* vendor-class interface index */
+#define APP_TUSB_MUX_ITF                0
+
+/* interval of credit checks while host sends nothing */
+#define APP_TUSB_MUX_CREDIT_MS          5
+/* retransmit buffer space freed before a new credit is sent */
+#define APP_TUSB_MUX_CREDIT_STEP        (APP_LINK_TX_STREAM_SIZE / 4)
+
+#define APP_TUSB_MUX_READ_SIZE          512
+
+/** @} */ // End of app_tusb_mux_define group
+
+/**
+ * @addtogroup app_tusb_mux_static_vars
+ * @{
+ */
+static const char *TAG = "app_tusb_mux";
+
+static uint8_t s_app_tusb_mux_stream_first = 0;
+
+/* given when host data is received */
+static SemaphoreHandle_t s_app_tusb_mux_rx = NULL;
+/* keeps frames of different writers whole */
+static SemaphoreHandle_t s_app_tusb_mux_tx_lock = NULL;
+
+/* frame being received from host */
+static uint8_t s_app_tusb_mux_frame[APP_TUSB_MUX_HEADER_LEN + APP_TUSB_MUX_PAYLOAD_MAX];
+static size_t s_app_tusb_mux_frame_len = 0;
+
+/* line coding last set by host, per link session */
+static config_settings_t s_app_tusb_mux_config[APP_LINK_SESSION_COUNT];
+/* data bytes received from host and credit limit last sent, per link session */
+static uint32_t s_app_tusb_mux_received[APP_LINK_SESSION_COUNT];
+static uint32_t s_app_tusb_mux_limit[APP_LINK_SESSION_COUNT];
+
+/** @} */ // End of app_tusb_mux_static_vars group
+
+/**
+ * @addtogroup app_tusb_mux_static_funcs
+ * @{
+ */
+
+/**
+ * @brief task which receives frames from host and keeps stream credits up to date
+ *
+ * @param pvParameter task parameters
+ */
+static void app_tusb_mux_task(void *pvParameter);
+
+/**
+ * @brief reassembles frames from bytes received from host
+ *
+ * @param data bytes received
+ * @param len length of bytes
+ */
+static void app_tusb_mux_feed(const uint8_t *data, size_t len);
+
+/**
+ * @brief handles one complete frame received from host
+ *
+ * @param type frame type
+ * @param stream stream of frame
+ * @param payload frame payload
+ * @param len length of payload
+ */
+static void app_tusb_mux_frame_received(uint8_t type, uint8_t stream, const uint8_t *payload, size_t len);
+
+/**
+ * @brief sends one frame to host, dropped if host is not connected
+ *
+ * @param type frame type
+ * @param stream stream of frame
+ * @param payload frame payload
+ * @param len length of payload, at most APP_TUSB_MUX_PAYLOAD_MAX
+ */
+static void app_tusb_mux_send(uint8_t type, uint8_t stream, const void *payload, size_t len);
+
+/**
+ * @brief writes bytes to vendor-class interface, waiting for fifo space while host is connected
+ *
+ * @param data bytes to write
+ * @param len length of bytes
+ */
+static void app_tusb_mux_write_all(const uint8_t *data, size_t len);
+
+/**
+ * @brief sends credit of a stream when enough retransmit buffer space was freed since the last one
+ *
+ * @param stream stream of peer
+ * @param force true to send credit regardless of freed space
+ */
+static void app_tusb_mux_credit_update(uint8_t stream, bool force);
+
+/**
+ * @brief checks if a stream is carried by the multiplexer
+ *
+ * @param stream stream of frame
+ * @return true if stream is a link session without CDC port
+ */
+static bool app_tusb_mux_stream_valid(uint8_t stream);
+
+/** @} */ // End of app_tusb_mux_static_funcs group
+
+/**
+ * @addtogroup app_tusb_mux_static_funcs
+ * @{
+ */
+
+/**
+ * @brief task which receives frames from host and keeps stream credits up to date
+ *
+ * @param pvParameter task parameters
+ */
+static void app_tusb_mux_task(void *pvParameter)
+{
+    static uint8_t buf[APP_TUSB_MUX_READ_SIZE];
+
+    while(true) {
+        xSemaphoreTake(s_app_tusb_mux_rx, pdMS_TO_TICKS(APP_TUSB_MUX_CREDIT_MS));
+
+        uint32_t rx_size = 0;
+        while((rx_size = tud_vendor_n_read(APP_TUSB_MUX_ITF, buf, sizeof(buf))) != 0) {
+            app_tusb_mux_feed(buf, rx_size);
+        }
+        for(uint8_t stream = s_app_tusb_mux_stream_first; stream < APP_LINK_SESSION_COUNT; stream++) {
+            app_tusb_mux_credit_update(stream, false);
+        }
+    }
+}
+
+/**
+ * @brief reassembles frames from bytes received from host
+ *
+ * @param data bytes received
+ * @param len length of bytes
+ */
+static void app_tusb_mux_feed(const uint8_t *data, size_t len)
+{
+    uint8_t *frame = s_app_tusb_mux_frame;
+
+    while(len != 0) {
+        size_t need = 0;
+        size_t copy = 0;
+
+        if(s_app_tusb_mux_frame_len == 0) {
+            // skip to next frame start, after a host restart or a malformed frame
+            const uint8_t *sync = memchr(data, APP_TUSB_MUX_SYNC, len);
+            if(sync == NULL) {
+                return;
+            }
+            len -= (size_t)(sync - data);
+            data = sync;
+        }
+
+        if(s_app_tusb_mux_frame_len < APP_TUSB_MUX_HEADER_LEN) {
+            need = APP_TUSB_MUX_HEADER_LEN - s_app_tusb_mux_frame_len;
+        } else {
+            need = APP_TUSB_MUX_HEADER_LEN + (frame[3] | (frame[4] << 8)) - s_app_tusb_mux_frame_len;
+        }
+        copy = (need < len) ? need : len;
+        memcpy(&frame[s_app_tusb_mux_frame_len], data, copy);
+        s_app_tusb_mux_frame_len += copy;
+        data += copy;
+        len -= copy;
+
+        if(s_app_tusb_mux_frame_len < APP_TUSB_MUX_HEADER_LEN) {
+            continue;
+        }
+        size_t payload_len = frame[3] | (frame[4] << 8);
+        if(payload_len > APP_TUSB_MUX_PAYLOAD_MAX) {
+            ESP_LOGE(TAG, "frame too long: %u", (unsigned int)payload_len);
+            s_app_tusb_mux_frame_len = 0;
+            continue;
+        }
+        if(s_app_tusb_mux_frame_len == APP_TUSB_MUX_HEADER_LEN + payload_len) {
+            app_tusb_mux_frame_received(frame[1], frame[2], &frame[APP_TUSB_MUX_HEADER_LEN], payload_len);
+            s_app_tusb_mux_frame_len = 0;
+        }
+    }
+}
+
+/**
+ * @brief handles one complete frame received from host
+ *
+ * @param type frame type
+ * @param stream stream of frame
+ * @param payload frame payload
+ * @param len length of payload
+ */
+static void app_tusb_mux_frame_received(uint8_t type, uint8_t stream, const uint8_t *payload, size_t len)
+{
+    switch(type) {
+        case APP_TUSB_MUX_TYPE_DATA: {
+            if(app_tusb_mux_stream_valid(stream)) {
+                // within credit the retransmit buffer has room, so this does not block other streams
+                s_app_tusb_mux_received[stream] += len;
+                app_link_data_send(stream, payload, len);
+            }
+        } break;
+        case APP_TUSB_MUX_TYPE_CONFIG: {
+            app_tusb_mux_config_t config;
+            if(app_tusb_mux_stream_valid(stream) && len >= sizeof(config)) {
+                config_settings_t *config_settings = &s_app_tusb_mux_config[stream];
+                memcpy(&config, payload, sizeof(config));
+                config_settings->bitrate = config.bitrate;
+                config_settings->data_bits = config.data_bits;
+                config_settings->parity = config.parity;
+                config_settings->stop_bits = config.stop_bits;
+                config_settings->hw_flow_status = config.hw_flow_status;
+                config_settings->sw_flow_status = CONFIG_UART_SW_FLOW_ENABLE;
+                ESP_LOGE(TAG, "stream %u bit_rate: %lu", stream, (unsigned long)config.bitrate);
+                // data frames before this one are already queued, so settings follow them in the stream
+                app_link_send_timeout_update(stream, config_settings->bitrate);
+                app_link_config_settings_send(stream, *config_settings);
+            }
+        } break;
+        case APP_TUSB_MUX_TYPE_HW_LINE: {
+            app_tusb_mux_hw_line_t hw_line;
+            if(app_tusb_mux_stream_valid(stream) && len >= sizeof(hw_line)) {
+                config_hw_line_t config_hw_line;
+                memcpy(&hw_line, payload, sizeof(hw_line));
+                config_hw_line.dtr = hw_line.dtr;
+                config_hw_line.rts = hw_line.rts;
+                app_link_config_hw_line_send(stream, config_hw_line);
+            }
+        } break;
+        case APP_TUSB_MUX_TYPE_INFO_REQ: {
+            app_tusb_mux_info_t info;
+            memset(&info, 0, sizeof(info));
+            info.version = APP_TUSB_MUX_VERSION;
+            info.stream_first = s_app_tusb_mux_stream_first;
+            info.stream_count = APP_LINK_SESSION_COUNT - s_app_tusb_mux_stream_first;
+            info.payload_max = APP_TUSB_MUX_PAYLOAD_MAX;
+            app_tusb_mux_send(APP_TUSB_MUX_TYPE_INFO, APP_TUSB_MUX_STREAM_NONE, &info, sizeof(info));
+            // host (re)starts counting from the credit of each stream
+            for(uint8_t i = s_app_tusb_mux_stream_first; i < APP_LINK_SESSION_COUNT; i++) {
+                app_tusb_mux_credit_update(i, true);
+            }
+        } break;
+        case APP_TUSB_MUX_TYPE_STATS_REQ: {
+            app_link_stats_t link_stats;
+            app_tusb_mux_stats_t stats;
+            if(stream >= APP_LINK_SESSION_COUNT) {
+                break;
+            }
+            app_link_stats_get(stream, &link_stats);
+            memset(&stats, 0, sizeof(stats));
+            stats.frames_sent = link_stats.frames_sent;
+            stats.frames_retx = link_stats.frames_retx;
+            stats.frames_dropped = link_stats.frames_dropped;
+            stats.bytes_acked = link_stats.bytes_acked;
+            stats.loss = link_stats.loss;
+            stats.tx_rate = link_stats.tx_rate;
+            stats.rx_rate = link_stats.rx_rate;
+            stats.crypto_rejected = link_stats.crypto_rejected;
+            stats.mtu = (uint16_t)link_stats.mtu;
+            stats.chunk = (uint16_t)link_stats.chunk;
+            stats.rssi = link_stats.rssi;
+            stats.tx_power = link_stats.tx_power;
+            stats.hops = link_stats.hops;
+            app_tusb_mux_send(APP_TUSB_MUX_TYPE_STATS, stream, &stats, sizeof(stats));
+        } break;
+        default: {
+        } break;
+    }
+}
+
+/**
+ * @brief sends one frame to host, dropped if host is not connected
+ *
+ * @param type frame type
+ * @param stream stream of frame
+ * @param payload frame payload
+ * @param len length of payload, at most APP_TUSB_MUX_PAYLOAD_MAX
+ */
+static void app_tusb_mux_send(uint8_t type, uint8_t stream, const void *payload, size_t len)
+{
+    uint8_t header[APP_TUSB_MUX_HEADER_LEN];
+
+    header[0] = APP_TUSB_MUX_SYNC;
+    header[1] = type;
+    header[2] = stream;
+    header[3] = (uint8_t)(len & 0xFF);
+    header[4] = (uint8_t)(len >> 8);
+
+    xSemaphoreTake(s_app_tusb_mux_tx_lock, portMAX_DELAY);
+    app_tusb_mux_write_all(header, sizeof(header));
+    app_tusb_mux_write_all(payload, len);
+    xSemaphoreGive(s_app_tusb_mux_tx_lock);
+}
+
+/**
+ * @brief writes bytes to vendor-class interface, waiting for fifo space while host is connected
+ *
+ * @param data bytes to write
+ * @param len length of bytes
+ */
+static void app_tusb_mux_write_all(const uint8_t *data, size_t len)
+{
+    while(len != 0) {
+        if(!tud_vendor_n_mounted(APP_TUSB_MUX_ITF)) {
+            return;
+        }
+        uint32_t space = tud_vendor_n_write_available(APP_TUSB_MUX_ITF);
+        if(space == 0) {
+            vTaskDelay(1);
+            continue;
+        }
+        uint32_t written = tud_vendor_n_write(APP_TUSB_MUX_ITF, data, (len < space) ? len : space);
+        data += written;
+        len -= written;
+    }
+}
+
+/**
+ * @brief sends credit of a stream when enough retransmit buffer space was freed since the last one
+ *
+ * @param stream stream of peer
+ * @param force true to send credit regardless of freed space
+ */
+static void app_tusb_mux_credit_update(uint8_t stream, bool force)
+{
+    app_tusb_mux_credit_t credit;
+    uint32_t limit = s_app_tusb_mux_received[stream] + app_link_tx_space_get(stream);
+
+    if(!force && (limit - s_app_tusb_mux_limit[stream]) < APP_TUSB_MUX_CREDIT_STEP) {
+        return;
+    }
+    s_app_tusb_mux_limit[stream] = limit;
+    credit.received = s_app_tusb_mux_received[stream];
+    credit.limit = limit;
+    app_tusb_mux_send(APP_TUSB_MUX_TYPE_CREDIT, stream, &credit, sizeof(credit));
+}
+
+/**
+ * @brief checks if a stream is carried by the multiplexer
+ *
+ * @param stream stream of frame
+ * @return true if stream is a link session without CDC port
+ */
+static bool app_tusb_mux_stream_valid(uint8_t stream)
+{
+    return stream >= s_app_tusb_mux_stream_first && stream < APP_LINK_SESSION_COUNT;
+}
+
+/** @} */ // End of app_tusb_mux_static_funcs group
+
+/**
+ * @addtogroup app_tusb_mux_global_funcs
+ * @{
+ */
+
+/**
+ * @brief tinyusb vendor-class receive callback function
+ *
+ * @param itf vendor-class interface
+ */
+void tud_vendor_rx_cb(uint8_t itf)
+{
+    xSemaphoreGive(s_app_tusb_mux_rx);
+}
+
+/**
+ * @brief initialize the usb multiplexer on the vendor-class interface
+ *
+ * @param stream_first first link session carried by the interface
+ * @return  esp error code
+ */
+int app_tusb_mux_init(uint8_t stream_first)
+{
+    s_app_tusb_mux_stream_first = stream_first;
+    for(uint8_t stream = 0; stream < APP_LINK_SESSION_COUNT; stream++) {
+        config_settings_t *config_settings = &s_app_tusb_mux_config[stream];
+        config_settings->bitrate = 9600;
+        config_settings->data_bits = 8;
+        config_settings->parity = 0;
+        config_settings->stop_bits = 0;
+        config_settings->hw_flow_status = APP_TUSB_HW_FLOW_DISABLE;
+        config_settings->sw_flow_status = CONFIG_UART_SW_FLOW_ENABLE;
+    }
+
+    s_app_tusb_mux_rx = xSemaphoreCreateBinary();
+    s_app_tusb_mux_tx_lock = xSemaphoreCreateMutex();
+    if(s_app_tusb_mux_rx == NULL || s_app_tusb_mux_tx_lock == NULL) {
+        ESP_LOGE(TAG, "Create semaphore fail");
+        return ESP_FAIL;
+    }
+
+    xTaskCreate(app_tusb_mux_task, "app_tusb_mux_task", 4096, NULL, 3, NULL);
+    ESP_LOGI(TAG, "streams %u to %u on vendor interface", stream_first, APP_LINK_SESSION_COUNT - 1);
+    return ESP_OK;
+}
+
+/**
+ * @brief writes serial data received from a peer to host
+ *
+ * @param stream link session of peer
+ * @param data data bytes
+ * @param len length of data
+ */
+void app_tusb_mux_write(uint8_t stream, const uint8_t *data, size_t len)
+{
+    while(len != 0) {
+        size_t chunk = (len < APP_TUSB_MUX_PAYLOAD_MAX) ? len : APP_TUSB_MUX_PAYLOAD_MAX;
+        app_tusb_mux_send(APP_TUSB_MUX_TYPE_DATA, stream, data, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * @brief sends line coding last set by host for a stream to its peer
+ *
+ * @param stream link session of peer
+ */
+void app_tusb_mux_config_request(uint8_t stream)
+{
+    app_link_config_settings_send(stream, s_app_tusb_mux_config[stream]);
+}
+
+/** @} */ // End of app_tusb_mux_global_funcs group
+#endif
+
+/** @} */ // End of app_tusb_mux module
@@ -0,0 +1,171 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_tusb_mux.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application usb multiplexer header, wire format shared with host library tools/wiser_mux.py
+ */
+
+#ifndef APP_TUSB_MUX_H
+#define APP_TUSB_MUX_H
+
+/**
+ * @defgroup app_tusb_mux Application usb multiplexer Module
+ * @brief Module for carrying serial streams of many peers over one USB vendor-class interface
+ * @{
+ */
+
+/**
+ * @addtogroup app_tusb_mux_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "commons.h"
+/** @} */ // End of app_tusb_mux_include group
+
+/**
+ * @addtogroup app_tusb_mux_define
+ * @{
+ */
+
+/* 1 if WiSer-USB carries peers without a CDC port over the vendor-class interface */
+#if (DEVICE_CONFIG_MODE == DEVICE_CONFIG_MODE_USB) && CONFIG_USB_MUX_ENABLE
+#define APP_TUSB_MUX_ENABLE             1
+#else
+#define APP_TUSB_MUX_ENABLE             0
+#endif
+
+#define APP_TUSB_MUX_VERSION            1
+
+/* every frame starts with sync byte, type, stream and little endian payload length */
+#define APP_TUSB_MUX_SYNC               0xA5
+#define APP_TUSB_MUX_HEADER_LEN         5
+#define APP_TUSB_MUX_PAYLOAD_MAX        512
+
+/* stream of frames not bound to a peer */
+#define APP_TUSB_MUX_STREAM_NONE        0xFF
+
+/** @} */ // End of app_tusb_mux_define group
+
+/**
+ * @addtogroup app_tusb_mux_types
+ * @{
+ */
+typedef enum {
+    APP_TUSB_MUX_TYPE_DATA=0,       /**< serial bytes, host to device and device to host */
+    APP_TUSB_MUX_TYPE_CONFIG,       /**< line coding of stream, app_tusb_mux_config_t, host to device */
+    APP_TUSB_MUX_TYPE_HW_LINE,      /**< DTR/RTS of stream, app_tusb_mux_hw_line_t, host to device */
+    APP_TUSB_MUX_TYPE_INFO_REQ,     /**< request for app_tusb_mux_info_t, host to device */
+    APP_TUSB_MUX_TYPE_INFO,         /**< app_tusb_mux_info_t followed by credit of every stream, device to host */
+    APP_TUSB_MUX_TYPE_STATS_REQ,    /**< request for link statistics of stream, host to device */
+    APP_TUSB_MUX_TYPE_STATS,        /**< app_tusb_mux_stats_t, device to host */
+    APP_TUSB_MUX_TYPE_CREDIT,       /**< app_tusb_mux_credit_t, device to host */
+} app_tusb_mux_type_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t bitrate;
+    uint8_t data_bits;
+    uint8_t parity;
+    uint8_t stop_bits;
+    uint8_t hw_flow_status;
+} app_tusb_mux_config_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t dtr;
+    uint8_t rts;
+} app_tusb_mux_hw_line_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t stream_first;           /**< first stream carried by the interface, lower streams are CDC ports */
+    uint8_t stream_count;           /**< streams carried by the interface */
+    uint8_t reserved;
+    uint16_t payload_max;           /**< largest payload accepted by the device */
+} app_tusb_mux_info_t;
+
+/* host data is only accepted up to the limit, so one slow peer never stalls the shared pipe */
+typedef struct __attribute__((packed)) {
+    uint32_t received;              /**< data bytes of stream received from host since device start */
+    uint32_t limit;                 /**< host may send data bytes of stream up to this count */
+} app_tusb_mux_credit_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t frames_sent;
+    uint32_t frames_retx;
+    uint32_t frames_dropped;
+    uint32_t bytes_acked;
+    uint32_t loss;
+    uint32_t tx_rate;
+    uint32_t rx_rate;
+    uint32_t crypto_rejected;
+    uint16_t mtu;
+    uint16_t chunk;
+    int8_t rssi;
+    int8_t tx_power;
+    uint8_t hops;
+    uint8_t reserved;
+} app_tusb_mux_stats_t;
+
+/** @} */ // End of app_tusb_mux_types group
+
+#if APP_TUSB_MUX_ENABLE
+/**
+ * @addtogroup app_tusb_mux_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize the usb multiplexer on the vendor-class interface
+ *
+ * @param stream_first first link session carried by the interface
+ * @return  esp error code
+ */
+int app_tusb_mux_init(uint8_t stream_first);
+
+/**
+ * @brief writes serial data received from a peer to host
+ *
+ * @param stream link session of peer
+ * @param data data bytes
+ * @param len length of data
+ */
+void app_tusb_mux_write(uint8_t stream, const uint8_t *data, size_t len);
+
+/**
+ * @brief sends line coding last set by host for a stream to its peer
+ *
+ * @param stream link session of peer
+ */
+void app_tusb_mux_config_request(uint8_t stream);
+
+/** @} */ // End of app_tusb_mux_global_funcs group
+#endif
+
+/** @} */ // End of app_tusb_mux group
+
+#endif  // End of APP_TUSB_MUX_H
@@ -0,0 +1,230 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_txpwr.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application transmit power control module which keeps transmit power just above what the peer needs
+ *
+ * Each device periodically reports to its peer the RSSI of the frames it receives from it.
+ * The sender compares the reported RSSI with CONFIG_TXPWR_RSSI_TARGET and combines it with
+ * its own data frame loss. Power goes up quickly when the margin is gone or frames are lost,
+ * and comes down slowly while the margin is comfortable and the channel is clean.
+ */
+
+/**
+ * @defgroup app_txpwr Application transmit power control Module
+ * @brief Module for adjusting transmit power to the RSSI and frame loss reported by peer
+ * @{
+ */
+
+/**
+ * @addtogroup app_txpwr_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "commons.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "app_link.h"
+#include "app_txpwr.h"
+
+/** @} */ // End of app_txpwr_include group
+
+/**
+ * @addtogroup app_txpwr_static_vars
+ * @{
+ */
+
+/**
+ * @brief Tag used for logging in this module
+ */
+static const char *TAG = "app_txpwr";
+
+static int8_t s_app_txpwr_max = 0;
+static volatile int8_t s_app_txpwr = 0;
+
+/* last report from each peer, power is shared by all sessions so the worst peer decides */
+static volatile int8_t s_app_txpwr_peer_rssi[APP_LINK_SESSION_COUNT];
+static volatile uint8_t s_app_txpwr_report_miss[APP_LINK_SESSION_COUNT];
+
+/** @} */ // End of app_txpwr_static_vars group
+
+/**
+ * @addtogroup app_txpwr_static_funcs
+ * @{
+ */
+
+/**
+ * @brief task which reports local link view to peer and adjusts transmit power
+ *
+ * @param pvParameter task parameters
+ */
+static void app_txpwr_task(void *pvParameter);
+
+/**
+ * @brief moves transmit power by step within configured bounds
+ *
+ * @param step change in units of 0.25 dBm
+ */
+static void app_txpwr_adjust(int step);
+
+/** @} */ // End of app_txpwr_static_funcs group
+
+/**
+ * @addtogroup app_txpwr_static_funcs
+ * @{
+ */
+
+/**
+ * @brief moves transmit power by step within configured bounds
+ *
+ * @param step change in units of 0.25 dBm
+ */
+static void app_txpwr_adjust(int step)
+{
+    int power = s_app_txpwr + step;
+
+    if(power > s_app_txpwr_max) {
+        power = s_app_txpwr_max;
+    }
+    if(power < CONFIG_TXPWR_MIN) {
+        power = CONFIG_TXPWR_MIN;
+    }
+    if(power != s_app_txpwr) {
+        s_app_txpwr = (int8_t)power;
+        app_link_tx_power_set(s_app_txpwr);
+        ESP_LOGE(TAG, "tx_power: %d", s_app_txpwr);
+    }
+}
+
+/**
+ * @brief task which reports local link view to peer and adjusts transmit power
+ *
+ * @param pvParameter task parameters
+ */
+static void app_txpwr_task(void *pvParameter)
+{
+    link_report_t link_report;
+    app_link_stats_t stats;
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_TXPWR_PERIOD_MS));
+
+        bool miss = false;
+        bool up = false;
+        bool down = true;
+        for(uint8_t i = 0; i < APP_LINK_SESSION_COUNT; i++) {
+            app_link_stats_get(i, &stats);
+
+            memset(&link_report, 0, sizeof(link_report));
+            link_report.rssi = app_link_rssi_get(i);
+            link_report.loss = (uint8_t)stats.loss;
+            link_report.tx_power = s_app_txpwr;
+            app_link_report_send(i, link_report);
+
+            if(s_app_txpwr_report_miss[i] >= APP_TXPWR_REPORT_MISS_MAX) {
+                // peer may not hear us at all
+                miss = true;
+                continue;
+            }
+            s_app_txpwr_report_miss[i]++;
+
+            // raise power for the worst peer, lower it only while every peer has margin
+            int8_t peer_rssi = s_app_txpwr_peer_rssi[i];
+            int margin = peer_rssi - CONFIG_TXPWR_RSSI_TARGET;
+            if(stats.loss > CONFIG_TXPWR_LOSS_HIGH || (peer_rssi != 0 && margin < 0)) {
+                up = true;
+            }
+            if(peer_rssi == 0 || margin <= CONFIG_TXPWR_RSSI_HYSTERESIS || stats.loss != 0) {
+                down = false;
+            }
+        }
+
+        if(miss) {
+            app_txpwr_adjust(s_app_txpwr_max);
+        } else if(up) {
+            app_txpwr_adjust(APP_TXPWR_STEP_UP);
+        } else if(down) {
+            app_txpwr_adjust(-APP_TXPWR_STEP_DOWN);
+        }
+    }
+}
+
+/** @} */ // End of app_txpwr_static_funcs group
+
+/**
+ * @addtogroup app_txpwr_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize transmit power control and start periodic link reports to peer
+ *
+ */
+void app_txpwr_init(void)
+{
+    s_app_txpwr_max = app_link_tx_power_get();
+    s_app_txpwr = s_app_txpwr_max;
+#if CONFIG_TXPWR_CONTROL_ENABLE
+    xTaskCreate(app_txpwr_task, "app_txpwr_task", 2048, NULL, 2, NULL);
+#endif
+}
+
+/**
+ * @brief handles link report received from peer
+ *
+ * @param session link session of peer
+ * @param link_report peer view of the link
+ */
+void app_txpwr_report_received(uint8_t session, const link_report_t link_report)
+{
+    if(session >= APP_LINK_SESSION_COUNT) {
+        return;
+    }
+    s_app_txpwr_peer_rssi[session] = link_report.rssi;
+    s_app_txpwr_report_miss[session] = 0;
+}
+
+/**
+ * @brief current transmit power
+ *
+ * @return transmit power in units of 0.25 dBm
+ */
+int8_t app_txpwr_get(void)
+{
+    return s_app_txpwr;
+}
+
+/** @} */ // End of app_txpwr_global_funcs group
+
+/** @} */ // End of app_txpwr group
+
+/** @} */ // End of app_txpwr module
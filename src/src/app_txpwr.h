@@ -0,0 +1,94 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_txpwr.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application transmit power control header
+ */
+
+#ifndef APP_TXPWR_H
+#define APP_TXPWR_H
+
+/**
+ * @defgroup app_txpwr Application transmit power control Module
+ * @brief Module for adjusting transmit power to the RSSI and frame loss reported by peer
+ * @{
+ */
+
+/**
+ * @addtogroup app_txpwr_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "commons.h"
+/** @} */ // End of app_txpwr_include group
+
+/**
+ * @addtogroup app_txpwr_define
+ * @{
+ */
+
+/* transmit power is set in units of 0.25 dBm */
+#define APP_TXPWR_STEP_UP       8   /**< 2 dB, margin loss is fixed quickly */
+#define APP_TXPWR_STEP_DOWN     4   /**< 1 dB, power is given back slowly */
+
+/* reports missed in a row after which power returns to maximum */
+#define APP_TXPWR_REPORT_MISS_MAX   3
+
+/** @} */ // End of app_txpwr_define group
+
+/**
+ * @addtogroup app_txpwr_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize transmit power control and start periodic link reports to peer
+ *
+ */
+void app_txpwr_init(void);
+
+/**
+ * @brief handles link report received from peer
+ *
+ * @param session link session of peer
+ * @param link_report peer view of the link
+ */
+void app_txpwr_report_received(uint8_t session, const link_report_t link_report);
+
+/**
+ * @brief current transmit power
+ *
+ * @return transmit power in units of 0.25 dBm
+ */
+int8_t app_txpwr_get(void);
+
+/** @} */ // End of app_txpwr_global_funcs group
+
+/** @} */ // End of app_txpwr group
+
+#endif
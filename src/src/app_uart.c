@@ -45,10 +45,12 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "sdkconfig.h"
 #include "esp_intr_alloc.h"
+#include "esp_timer.h"
 #if CONFIG_IDF_TARGET_ESP32
     #include "esp32/rom/uart.h"
 #elif CONFIG_IDF_TARGET_ESP32S2
@@ -56,9 +58,11 @@
 #endif
 #include "config.h"
 #include "commons.h"
-#include "app_espnow.h"
+#include "app_link.h"
 #include "app_conn.h"
 #include "app_uart.h"
+#include "app_uart_dma.h"
+#include "app_uart_autobaud.h"
 
 /** @} */ // End of app_uart_include group
 #if DEVICE_WISER_UART
@@ -92,6 +96,79 @@
 /** @brief UART buffer size */
 #define BUF_SIZE (2048)
 
+#define APP_UART_BITRATE_MAX        CONFIG_UART_BITRATE_MAX
+#if APP_UART_BITRATE_MAX > 5000000
+#error CONFIG_UART_BITRATE_MAX must be at most 5000000!
+#endif
+#if (CONFIG_UART_RX_PROFILE < 0) || (CONFIG_UART_RX_PROFILE > 2)
+#error CONFIG_UART_RX_PROFILE must be 0, 1 or 2!
+#endif
+#if (CONFIG_UART_RX_DELIMITER < -1) || (CONFIG_UART_RX_DELIMITER > 0xFF)
+#error CONFIG_UART_RX_DELIMITER must be a byte value or -1!
+#endif
+/* driver buffers hold this long of serial data at highest bitrate, at least their size for 921600 */
+#define APP_UART_RX_BUF_MS          40
+#define APP_UART_TX_BUF_MS          20
+#define APP_UART_BUF_BYTES(ms)      ((uint32_t)(((uint64_t)APP_UART_BITRATE_MAX * (ms)) / 10000))
+#define APP_UART_RX_BUF_SIZE        ((APP_UART_BUF_BYTES(APP_UART_RX_BUF_MS) > BUF_SIZE*8) ? APP_UART_BUF_BYTES(APP_UART_RX_BUF_MS) : BUF_SIZE*8)
+#define APP_UART_TX_BUF_SIZE        ((APP_UART_BUF_BYTES(APP_UART_TX_BUF_MS) > BUF_SIZE) ? APP_UART_BUF_BYTES(APP_UART_TX_BUF_MS) : BUF_SIZE)
+/* FIFO bytes below which transmit interrupt refills it, low enough to leave the FIFO to the hardware */
+#define APP_UART_TX_EMPTY_THRESH_MIN    10
+#define APP_UART_TX_EMPTY_THRESH_MAX    (UART_FIFO_LEN / 2)
+
+/* bytes held by driver and hardware before new settings apply, drained at up to 12 bits per byte */
+#define APP_UART_TX_DRAIN_BYTES     (APP_UART_TX_BUF_SIZE + 128)
+#define APP_UART_TX_DRAIN_MS(baud)  ((uint32_t)(((uint64_t)APP_UART_TX_DRAIN_BYTES * 12 * 1000) / (baud)) + 10)
+
+#define APP_UART_RX_RING_SIZE       CONFIG_UART_RX_RING_SIZE
+#if (APP_UART_RX_RING_SIZE & (APP_UART_RX_RING_SIZE - 1)) != 0
+#error CONFIG_UART_RX_RING_SIZE must be power of 2!
+#endif
+
+#define APP_UART_TX_RING_SIZE       CONFIG_UART_TX_RING_SIZE
+#if (APP_UART_TX_RING_SIZE & (APP_UART_TX_RING_SIZE - 1)) != 0 || APP_UART_TX_RING_SIZE < (APP_LINK_TX_STREAM_SIZE * 2)
+#error CONFIG_UART_TX_RING_SIZE must be power of 2, at least 16384!
+#endif
+/* peer is held off with room left for its whole link stream and frames in flight */
+#define APP_UART_TX_HIGH_WATERMARK  (APP_UART_TX_RING_SIZE - APP_LINK_TX_STREAM_SIZE - (APP_UART_TX_RING_SIZE / 8))
+#define APP_UART_TX_LOW_WATERMARK   (APP_UART_TX_HIGH_WATERMARK / 2)
+/* transmit ring drained at up to 12 bits per byte before new settings apply anyway */
+#define APP_UART_TX_RING_DRAIN_MS(baud) ((uint32_t)(((uint64_t)APP_UART_TX_RING_SIZE * 12 * 1000) / (baud)) + 10)
+/* tx task rechecks XOFF of target and pending settings this often in milliseconds */
+#define APP_UART_TX_POLL_MS         100
+/* largest write to UART driver, so XON/XOFF for target waiting on a full FIFO is retried in between */
+#define APP_UART_TX_WRITE_MAX       (APP_UART_TX_BUF_SIZE / 4)
+
+/* receive timeout register counts bit times */
+#define APP_UART_RX_TOUT_BITS_MAX       1023
+/* FIFO room above receive threshold, covers interrupt latency before bytes are lost */
+#define APP_UART_RX_ISR_LATENCY_US      100
+#define APP_UART_RX_FIFO_HEADROOM_MIN   8
+/* delimiter positions kept by driver, popped on every pattern event */
+#define APP_UART_RX_PATTERN_QUEUE_SIZE  32
+
+#define APP_UART_RX_BACKPRESSURE        CONFIG_UART_RX_BACKPRESSURE
+#define APP_UART_RX_HIGH_WATERMARK      ((APP_UART_RX_RING_SIZE * CONFIG_UART_RX_HIGH_WATERMARK) / 100)
+#define APP_UART_RX_LOW_WATERMARK       ((APP_UART_RX_RING_SIZE * CONFIG_UART_RX_LOW_WATERMARK) / 100)
+#if CONFIG_UART_RX_LOW_WATERMARK >= CONFIG_UART_RX_HIGH_WATERMARK || CONFIG_UART_RX_HIGH_WATERMARK > 100
+#error CONFIG_UART_RX_LOW_WATERMARK must be below CONFIG_UART_RX_HIGH_WATERMARK, at most 100!
+#endif
+#define APP_UART_XON                    0x11
+#define APP_UART_XOFF                   0x13
+/* with XON/XOFF, serial data for target goes out in chunks each sent before the next, bounding bytes after an XOFF of target */
+#define APP_UART_SW_FLOW_TX_CHUNK       64
+
+#define APP_UART_SERIAL_STATE_ENABLE    CONFIG_SERIAL_STATE_ENABLE
+/* CTS of target is sampled this often in milliseconds, a change is sent right away */
+#define APP_UART_SERIAL_STATE_POLL_MS   20
+
+/* edges on RX measured before bitrate is locked, text has about 4 per character */
+#define APP_UART_AUTOBAUD_EDGES         64
+#define APP_UART_AUTOBAUD_POLL_MS       10
+/* framing errors within a second after lock which mean target changed bitrate */
+#define APP_UART_AUTOBAUD_RELOCK_ERRORS 8
+#define APP_UART_AUTOBAUD_BITRATE_MIN   300
+
 /** @} */ // End of app_uart_define group
 
 
@@ -105,6 +182,88 @@ static const char *TAG = "app_uart";
 /** @brief Queue handle for UART */
 static QueueHandle_t uart1_queue;
 
+/* receive ring, only the event task moves head and only the rx task moves tail */
+static uint8_t s_app_uart_rx_ring[APP_UART_RX_RING_SIZE];
+static volatile uint32_t s_app_uart_rx_head = 0;
+static volatile uint32_t s_app_uart_rx_tail = 0;
+/* given when bytes are added to ring */
+static SemaphoreHandle_t s_app_uart_rx_data = NULL;
+/* set by event task when bytes were left in driver, rx task then wakes it once ring has room */
+static volatile bool s_app_uart_rx_stalled = false;
+static app_uart_rx_stats_t s_app_uart_rx_stats;
+
+/* transmit ring, only link moves head and only the tx task moves tail, so link never waits on target */
+static uint8_t s_app_uart_tx_ring[APP_UART_TX_RING_SIZE];
+static volatile uint32_t s_app_uart_tx_head = 0;
+static volatile uint32_t s_app_uart_tx_tail = 0;
+/* task writing transmit ring to target, notified when bytes or settings are added */
+static TaskHandle_t s_app_uart_tx_task_handle = NULL;
+/* peer is held off by flow control frame while transmit ring is above high watermark */
+static volatile bool s_app_uart_tx_held = false;
+static volatile int64_t s_app_uart_tx_held_time = 0;
+/* line settings applied by tx task once ring bytes written before them are sent */
+static portMUX_TYPE s_app_uart_tx_config_lock = portMUX_INITIALIZER_UNLOCKED;
+static config_settings_t s_app_uart_tx_config;
+static uint32_t s_app_uart_tx_config_pos = 0;
+static int64_t s_app_uart_tx_config_time = 0;
+static volatile bool s_app_uart_tx_config_pending = false;
+
+/* per profile, idle time before bytes are read, highest interrupt rate while streaming and largest driver read */
+typedef struct {
+    uint32_t timeout_us;
+    uint32_t events_per_sec_max;
+    uint32_t read_size;
+} app_uart_rx_profile_param_t;
+
+static const app_uart_rx_profile_param_t s_app_uart_rx_profile_params[APP_UART_RX_PROFILE_MAX] = {
+    [APP_UART_RX_PROFILE_LATENCY]    = { .timeout_us = 200,   .events_per_sec_max = 20000, .read_size = 64 },
+    [APP_UART_RX_PROFILE_BALANCED]   = { .timeout_us = 2000,  .events_per_sec_max = 5000,  .read_size = 512 },
+    [APP_UART_RX_PROFILE_THROUGHPUT] = { .timeout_us = 10000, .events_per_sec_max = 1000,  .read_size = APP_UART_RX_RING_SIZE },
+};
+static const app_uart_rx_profile_t s_app_uart_rx_profile = CONFIG_UART_RX_PROFILE;
+/* time of one character at current settings */
+static uint32_t s_app_uart_rx_char_ns = 0;
+static uint64_t s_app_uart_rx_latency_us_sum = 0;
+/* time of first start bit on RX since bytes were last moved to ring, 0 until an edge is seen */
+static volatile int64_t s_app_uart_rx_first_time = 0;
+static uint32_t s_app_uart_rx_latency_events = 0;
+/* delimiter detected by UART hardware, -1 when none */
+static const int s_app_uart_rx_delimiter = CONFIG_UART_RX_DELIMITER;
+
+#if APP_UART_RX_BACKPRESSURE
+/* serializes holding and releasing the sender between ring producer and rx task */
+static SemaphoreHandle_t s_app_uart_rx_flow_lock = NULL;
+static volatile bool s_app_uart_rx_held = false;
+/* XOFF was sent and needs XON on release, whatever flow control is in use by then */
+static bool s_app_uart_rx_xoff_sent = false;
+/* XON or XOFF not yet taken by a full transmit FIFO, 0 when none */
+static volatile char s_app_uart_rx_flow_char = 0;
+#endif
+
+/* target sent XOFF, writes to target wait for XON */
+static volatile bool s_app_uart_tx_xoff = false;
+static volatile int64_t s_app_uart_tx_xoff_time = 0;
+static SemaphoreHandle_t s_app_uart_tx_xon = NULL;
+/* task passing XON/XOFF state of target to peer */
+static TaskHandle_t s_app_uart_flow_task_handle = NULL;
+#if APP_UART_DMA_ENABLE
+/* task copying DMA receive buffers into ring, notified by rx task once a full ring has room */
+static TaskHandle_t s_app_uart_dma_rx_task_handle = NULL;
+#endif
+#if APP_UART_SERIAL_STATE_ENABLE
+/* task passing UART errors and CTS of target to peer, errors are set in its notification value */
+static TaskHandle_t s_app_uart_serial_state_task_handle = NULL;
+#endif
+#if APP_UART_AUTOBAUD_ENABLE
+/* task detecting bitrate of target, notified on a burst of framing errors */
+static TaskHandle_t s_app_uart_autobaud_task_handle = NULL;
+/* received bytes are dropped while bitrate is measured, they were read at the wrong one */
+static volatile bool s_app_uart_autobaud_detecting = false;
+static volatile uint32_t s_app_uart_autobaud_errors = 0;
+/* serializes UART settings between host configuration and auto-baud lock */
+static SemaphoreHandle_t s_app_uart_config_lock = NULL;
+#endif
+
 /** @} */ // End of app_uart_static_vars group
 
 /**
@@ -112,6 +271,7 @@ static QueueHandle_t uart1_queue;
  * @{
  */
 uint8_t app_uart_hw_flow_status = APP_UART_HW_FLOW_DISABLE;
+uint8_t app_uart_sw_flow_status = APP_UART_SW_FLOW_DISABLE;
 
 size_t total_uart_intr_received_len = 0;
 size_t total_espnow_sent_len = 0;
@@ -136,12 +296,33 @@ uart_config_t uart_config = {
 /** @brief Initialize UART low-level configuration */
 static void app_uart_ll_init(void);
 
+/**
+ * @brief enables UART pattern detection on receive delimiter, or disables it when there is none
+ * 
+ */
+static void app_uart_rx_delimiter_apply(void);
+
 /**
  * @brief Initialize uart pins and enable RTS/CTS hardware flow control.
  * 
  */
 static void app_uart_hw_flow_enable(void);
 
+#if !APP_UART_DMA_ENABLE
+/**
+ * @brief stamps first falling edge on RX, the start bit of first byte waiting to be read
+ * @param arg unused
+ * 
+ */
+static void app_uart_rx_edge_isr(void *arg);
+
+/**
+ * @brief clears first byte time and waits for next start bit on RX
+ * 
+ */
+static void app_uart_rx_edge_arm(void);
+#endif
+
 /**
  * @brief Initialize uart pins and disable RTS/CTS hardware flow control.
  * 
@@ -154,6 +335,142 @@ static void app_uart_dtr_init(void);
 /** @brief Task to handle UART events */
 static void app_uart_event_task(void *pvParameters);
 
+/**
+ * @brief moves bytes buffered by UART driver into receive ring, as far as it has room
+ * 
+ */
+static void app_uart_rx_ring_fill(void);
+
+/**
+ * @brief Task which passes bytes of receive ring to link, waiting on radio in place of UART ingest
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_rx_task(void *pvParameters);
+
+/**
+ * @brief applies receive timeout, FIFO threshold and read size of selected profile for current UART settings
+ * 
+ */
+static void app_uart_rx_tuning_apply(void);
+
+/**
+ * @brief holds the sender off once receive ring passes high watermark, releases it at low watermark
+ * @param reapply apply current state again, after UART settings were reset
+ * 
+ */
+static void app_uart_rx_backpressure_update(bool reapply);
+
+/**
+ * @brief removes XON/XOFF of target from received bytes, pausing or resuming writes to target
+ * @param data received bytes
+ * @param len count of received bytes
+ * 
+ * @return count of bytes left
+ */
+static size_t app_uart_rx_sw_flow_strip(uint8_t *data, size_t len);
+
+/**
+ * @brief Task which sends XON/XOFF state of target to peer, so host is held off as well
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_flow_task(void *pvParameters);
+
+/**
+ * @brief Task which writes transmit ring to target, waiting for XON and UART in place of link
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_tx_task(void *pvParameters);
+
+/**
+ * @brief applies pending line settings once bytes written before them are sent, or after drain timeout
+ * @param tail transmit ring tail
+ * 
+ */
+static void app_uart_tx_config_check(uint32_t tail);
+
+/**
+ * @brief applies UART line settings
+ * @param config_settings UART configuration settings
+ * 
+ */
+static void app_uart_config_apply(config_settings_t config_settings);
+
+/**
+ * @brief hands bytes to UART driver or DMA
+ * @param tx_buf transmit buffer
+ * @param tx_size buffer size
+ * 
+ */
+static void app_uart_tx_bytes(const uint8_t *tx_buf, size_t tx_size);
+
+/**
+ * @brief marks UART errors to be sent to peer, without waiting on the link
+ * @param errors SERIAL_STATE_ERRORS bits
+ * 
+ */
+static void app_uart_serial_state_notify(uint16_t errors);
+
+#if APP_UART_SERIAL_STATE_ENABLE
+/**
+ * @brief Task which sends UART errors and CTS of target to peer, repeated periodically as carrier for host
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_serial_state_task(void *pvParameters);
+#endif
+
+/**
+ * @brief counts a framing error towards detecting bitrate of target again
+ * 
+ */
+static void app_uart_autobaud_frame_error(void);
+
+#if APP_UART_AUTOBAUD_ENABLE
+/**
+ * @brief switches UART to detected bitrate
+ * @param bitrate detected bitrate
+ * 
+ */
+static void app_uart_autobaud_lock(uint32_t bitrate);
+
+/**
+ * @brief Task which measures bitrate of target, locks to it and reports it to peer
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_autobaud_task(void *pvParameters);
+#endif
+
+#if APP_UART_DMA_ENABLE
+/**
+ * @brief copies bytes into receive ring, as far as it has room
+ * @param data received bytes
+ * @param len count of received bytes
+ * 
+ * @return count of bytes copied
+ */
+static size_t app_uart_rx_ring_put(const uint8_t *data, size_t len);
+
+/**
+ * @brief Task which copies DMA receive buffers into receive ring
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_dma_rx_task(void *pvParameters);
+#endif
+
+#if CONFIG_STATS_LOG_PERIOD_MS
+/**
+ * @brief Task which logs receive ring statistics and receive latency periodically
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_stats_task(void *pvParameters);
+#endif
+
 /**
  * @brief initialize app UART tasks.
  * 
@@ -176,19 +493,89 @@ static void app_uart_ll_init(void)
 {
     int intr_alloc_flags = 0;
 
-    app_espnow_send_timeout = (uint32_t)((APP_ESPNOW_SEND_DATA_SIZE*8*1000)/uart_config.baud_rate) + (uint32_t)(1000/uart_config.baud_rate) + 20;
-    ESP_LOGE(TAG, "app_espnow_send_timeout: %lu", app_espnow_send_timeout);
+    app_link_send_timeout_update(APP_LINK_SESSION_DEFAULT, uart_config.baud_rate);
     gpio_pullup_dis(APP_UART_GPIO_CTS);
 
     intr_alloc_flags = ESP_INTR_FLAG_IRAM;
     
-    ESP_ERROR_CHECK(uart_driver_install(APP_UART_NUM, BUF_SIZE*8, BUF_SIZE, 200, &uart1_queue, intr_alloc_flags));
+    ESP_ERROR_CHECK(uart_driver_install(APP_UART_NUM, APP_UART_RX_BUF_SIZE, APP_UART_TX_BUF_SIZE, 200, &uart1_queue, intr_alloc_flags));
     uart_config.rx_flow_ctrl_thresh = UART_FIFO_LEN - 1;
     ESP_ERROR_CHECK(uart_param_config(APP_UART_NUM, &uart_config));
+    app_uart_rx_tuning_apply();
+#if APP_UART_DMA_ENABLE
+    // UHCI drains the FIFO, driver keeps only line configuration and error events
+    uart_disable_rx_intr(APP_UART_NUM);
+    ESP_ERROR_CHECK(app_uart_dma_init(APP_UART_NUM));
+#endif
+    app_uart_rx_delimiter_apply();
+#if !APP_UART_DMA_ENABLE
+    // RX stays routed to UART, the GPIO interrupt only stamps when a first byte starts
+    gpio_set_intr_type(APP_UART_GPIO_RX, GPIO_INTR_NEGEDGE);
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "rx latency not measured, gpio isr service: %d", err);
+    } else {
+        gpio_isr_handler_add(APP_UART_GPIO_RX, app_uart_rx_edge_isr, NULL);
+        app_uart_rx_edge_arm();
+    }
+#endif
     
     app_uart_hw_flow_disable();
 }
 
+#if !APP_UART_DMA_ENABLE
+/**
+ * @brief stamps first falling edge on RX, the start bit of first byte waiting to be read
+ * @param arg unused
+ * 
+ */
+static void IRAM_ATTR app_uart_rx_edge_isr(void *arg)
+{
+    // later edges would cost an interrupt per bit, rearmed once bytes reach the ring
+    gpio_intr_disable(APP_UART_GPIO_RX);
+    s_app_uart_rx_first_time = esp_timer_get_time();
+}
+
+/**
+ * @brief clears first byte time and waits for next start bit on RX
+ * 
+ */
+static void app_uart_rx_edge_arm(void)
+{
+    s_app_uart_rx_first_time = 0;
+    gpio_intr_enable(APP_UART_GPIO_RX);
+}
+#endif
+
+/**
+ * @brief enables UART pattern detection on receive delimiter, or disables it when there is none
+ * 
+ */
+static void app_uart_rx_delimiter_apply(void)
+{
+#if APP_UART_DMA_ENABLE
+    // UHCI drains the FIFO and ends transfers on idle only
+    s_app_uart_rx_stats.delimiter = -1;
+    if (s_app_uart_rx_delimiter >= 0) {
+        ESP_LOGE(TAG, "rx delimiter not supported with UART DMA");
+    }
+#else
+    s_app_uart_rx_stats.delimiter = -1;
+    if (s_app_uart_rx_delimiter < 0) {
+        uart_disable_pattern_det_intr(APP_UART_NUM);
+        return;
+    }
+    // single delimiter with no idle around it, a match interrupts at once like idle timeout does
+    if (uart_enable_pattern_det_baud_intr(APP_UART_NUM, (char)s_app_uart_rx_delimiter, 1, 1, 0, 0) != ESP_OK ||
+        uart_pattern_queue_reset(APP_UART_NUM, APP_UART_RX_PATTERN_QUEUE_SIZE) != ESP_OK) {
+        ESP_LOGE(TAG, "rx delimiter 0x%02x not applied", s_app_uart_rx_delimiter);
+        return;
+    }
+    s_app_uart_rx_stats.delimiter = s_app_uart_rx_delimiter;
+    ESP_LOGI(TAG, "rx delimiter 0x%02x", s_app_uart_rx_delimiter);
+#endif
+}
+
 
 /**
  * @brief Initialize uart pins and enable RTS/CTS hardware flow control.
@@ -241,52 +628,72 @@ static void app_uart_dtr_init(void)
  */
 static void IRAM_ATTR app_uart_event_task(void *pvParameters)
 {
-    static DRAM_ATTR app_uart_evt_data_t evt;
     static DRAM_ATTR uart_event_t event;
-    size_t buffered_size;
-    uint8_t *dtmp = (uint8_t *) pvPortMalloc(BUF_SIZE*20);
     while (1) {
         /* Waiting for UART event.
            If it happens then print out information what is it */
         if (xQueueReceive(uart1_queue, (void * )&event, portMAX_DELAY)) {
             // ESP_LOGI(TAG, "uart[%d] event:", APP_UART_NUM);
             switch (event.type) {
+            case UART_PATTERN_DET:
+                // delimiter ended the wait early, bytes are passed on as a whole so positions are dropped
+                s_app_uart_rx_stats.delimiter_events++;
+                while (uart_pattern_pop_pos(APP_UART_NUM) != -1) {
+                }
+                /* fall through */
             case UART_DATA:
-                /* Event of UART receiving data
-                 * We'd better handler data event fast, there would be much more data events
-                 * than other types of events.
-                 * If we take too much time on data event, the queue might be full.
-                 * In this example, we don't process data in event, but read data outside.
+                /* Event of UART receiving data, also posted by rx task once a full ring has room again.
+                 * Bytes only move to the ring here, so reading never waits on the radio.
                  */
-                uart_get_buffered_data_len(APP_UART_NUM, &buffered_size);
-                // ESP_LOGI(TAG, "data, len: %d; buffered len: %d", event.size, buffered_size);
-                evt.type = APP_UART_TYPE_DATA;
-                evt.len = buffered_size;
-                if (evt.len > 0) {
-                    const size_t rx_bytes = uart_read_bytes(APP_UART_NUM, dtmp, evt.len, 1000);
-                    app_espnow_data_send(dtmp, rx_bytes);
+                if (event.size > 0) {
+                    // from start bit of first byte to ring, covering threshold or idle wait, interrupt and task latency
+                    int64_t first_time = s_app_uart_rx_first_time;
+                    s_app_uart_rx_stats.events++;
+#if !APP_UART_DMA_ENABLE
+                    // bytes arriving while reading are stamped for the next event, a little early at worst
+                    app_uart_rx_edge_arm();
+#endif
+                    app_uart_rx_ring_fill();
+                    if (first_time != 0) {
+                        uint32_t latency_us = (uint32_t)(esp_timer_get_time() - first_time);
+                        s_app_uart_rx_latency_us_sum += latency_us;
+                        s_app_uart_rx_latency_events++;
+                        if (latency_us > s_app_uart_rx_stats.latency_us_max) {
+                            s_app_uart_rx_stats.latency_us_max = latency_us;
+                        }
+                    }
+                    break;
                 }
+                app_uart_rx_ring_fill();
                 break;
             case UART_FIFO_OVF:
+                // bytes are already lost in hardware, driver resets the FIFO and keeps what it buffered
                 ESP_LOGE(TAG, "hw fifo overflow");
-                // If fifo overflow happened, you should consider adding flow control for your application.
-                // We can read data out out the buffer, or directly flush the Rx buffer.
-                uart_flush(APP_UART_NUM);
+                s_app_uart_rx_stats.fifo_overflows++;
+                app_uart_serial_state_notify(SERIAL_STATE_OVERRUN);
+                app_uart_rx_ring_fill();
                 break;
             case UART_BUFFER_FULL:
+                // driver pauses receiving until read, bytes are kept instead of flushed
                 ESP_LOGE(TAG, "ring buffer full");
-                // If buffer full happened, you should consider increasing your buffer size
-                // We can read data out out the buffer, or directly flush the Rx buffer.
-                uart_flush(APP_UART_NUM);
+                s_app_uart_rx_stats.buffer_full++;
+                app_uart_rx_ring_fill();
                 break;
             case UART_BREAK:
                 ESP_LOGI(TAG, "uart rx break detected");
+                s_app_uart_rx_stats.breaks++;
+                app_uart_serial_state_notify(SERIAL_STATE_BREAK);
                 break;
             case UART_PARITY_ERR:
                 ESP_LOGE(TAG, "uart parity error");
+                s_app_uart_rx_stats.parity_errors++;
+                app_uart_serial_state_notify(SERIAL_STATE_PARITY);
                 break;
             case UART_FRAME_ERR:
                 ESP_LOGE(TAG, "uart frame error");
+                s_app_uart_rx_stats.frame_errors++;
+                app_uart_serial_state_notify(SERIAL_STATE_FRAMING);
+                app_uart_autobaud_frame_error();
                 break;
             default:
                 ESP_LOGE(TAG, "not serviced uart event type: %d\n", event.type);
@@ -294,55 +701,733 @@ static void IRAM_ATTR app_uart_event_task(void *pvParameters)
             }
         }
     }
-    vPortFree(dtmp);
-    dtmp = NULL;
     vTaskDelete(NULL);
 }
 
 /**
- * @brief initialize app UART tasks.
+ * @brief moves bytes buffered by UART driver into receive ring, as far as it has room
  * 
- * @return error code
  */
-static int app_uart_tasks_init(void)
+static void IRAM_ATTR app_uart_rx_ring_fill(void)
 {
-    // Create a task to handle uart event from ISR
-    xTaskCreate(app_uart_event_task, "app_uart_event_task", 14096, NULL, 3, NULL);
+    size_t buffered_size = 0;
+    uint32_t head = s_app_uart_rx_head;
 
-    return ESP_OK;
+#if APP_UART_AUTOBAUD_ENABLE
+    if (s_app_uart_autobaud_detecting) {
+        uart_flush_input(APP_UART_NUM);
+        return;
+    }
+#endif
+    uart_get_buffered_data_len(APP_UART_NUM, &buffered_size);
+    while (buffered_size > 0) {
+        uint32_t space = APP_UART_RX_RING_SIZE - (head - s_app_uart_rx_tail);
+        if (space == 0) {
+            // driver keeps the rest, with flow control RTS holds the sender off
+            s_app_uart_rx_stalled = true;
+            // rx task may have drained the ring before it saw the flag
+            if (APP_UART_RX_RING_SIZE - (head - s_app_uart_rx_tail) == 0) {
+                s_app_uart_rx_stats.stalls++;
+                break;
+            }
+            continue;
+        }
+        // read up to the end of the ring, a wrapped remainder is read in the next pass
+        uint32_t pos = head & (APP_UART_RX_RING_SIZE - 1);
+        size_t len = APP_UART_RX_RING_SIZE - pos;
+        if (len > space) {
+            len = space;
+        }
+        if (len > buffered_size) {
+            len = buffered_size;
+        }
+        // smaller reads let rx task start on the first bytes while the rest is read
+        if (len > s_app_uart_rx_stats.read_size) {
+            len = s_app_uart_rx_stats.read_size;
+        }
+        int rx_bytes = uart_read_bytes(APP_UART_NUM, &s_app_uart_rx_ring[pos], len, 0);
+        if (rx_bytes <= 0) {
+            break;
+        }
+        buffered_size -= rx_bytes;
+        if (app_uart_sw_flow_status == APP_UART_SW_FLOW_ENABLE) {
+            rx_bytes = app_uart_rx_sw_flow_strip(&s_app_uart_rx_ring[pos], rx_bytes);
+        }
+        head += rx_bytes;
+        s_app_uart_rx_head = head;
+        s_app_uart_rx_stats.bytes_in += rx_bytes;
+        xSemaphoreGive(s_app_uart_rx_data);
+    }
 
+    uint32_t occupancy = head - s_app_uart_rx_tail;
+    if (occupancy > s_app_uart_rx_stats.occupancy_max) {
+        s_app_uart_rx_stats.occupancy_max = occupancy;
+    }
+    xSemaphoreGive(s_app_uart_rx_data);
+    app_uart_rx_backpressure_update(false);
 }
 
-/** @} */ // End of app_uart_static_funcs group
+/**
+ * @brief holds the sender off once receive ring passes high watermark, releases it at low watermark
+ * @param reapply apply current state again, after UART settings were reset
+ * 
+ */
+static void app_uart_rx_backpressure_update(bool reapply)
+{
+#if APP_UART_RX_BACKPRESSURE
+    uint32_t occupancy = s_app_uart_rx_head - s_app_uart_rx_tail;
+    if (s_app_uart_rx_flow_lock == NULL) {
+        return;
+    }
+    // quick check, called on every ring update
+    if (!reapply && s_app_uart_rx_flow_char == 0 && (s_app_uart_rx_held ? (occupancy > APP_UART_RX_LOW_WATERMARK) : (occupancy < APP_UART_RX_HIGH_WATERMARK))) {
+        return;
+    }
+
+    xSemaphoreTake(s_app_uart_rx_flow_lock, portMAX_DELAY);
+    occupancy = s_app_uart_rx_head - s_app_uart_rx_tail;
+    bool hold = s_app_uart_rx_held;
+    if (!hold && occupancy >= APP_UART_RX_HIGH_WATERMARK) {
+        hold = true;
+        s_app_uart_rx_stats.holds++;
+    } else if (hold && occupancy <= APP_UART_RX_LOW_WATERMARK) {
+        hold = false;
+    }
+
+    if (hold != s_app_uart_rx_held || reapply) {
+        s_app_uart_rx_held = hold;
+        s_app_uart_rx_stats.held = hold;
+        if (app_uart_hw_flow_status == APP_UART_HW_FLOW_ENABLE) {
+            // UART only raises RTS on a full FIFO, so RTS is taken over while holding
+            if (hold) {
+                uart_set_hw_flow_ctrl(APP_UART_NUM, UART_HW_FLOWCTRL_CTS, 0);
+                uart_set_rts(APP_UART_NUM, 0);
+            } else {
+                uart_set_hw_flow_ctrl(APP_UART_NUM, UART_HW_FLOWCTRL_CTS_RTS, UART_FIFO_LEN - 1);
+            }
+        }
+        // RTS follows the host without flow control, in-band XOFF goes ahead of queued serial data
+        else if ((APP_UART_RX_BACKPRESSURE == 2 || app_uart_sw_flow_status == APP_UART_SW_FLOW_ENABLE) &&
+                 hold && !s_app_uart_rx_xoff_sent) {
+            s_app_uart_rx_flow_char = APP_UART_XOFF;
+            s_app_uart_rx_xoff_sent = true;
+        }
+        if (!hold && s_app_uart_rx_xoff_sent) {
+            // an XOFF still waiting for the FIFO needs no XON
+            s_app_uart_rx_flow_char = (s_app_uart_rx_flow_char == APP_UART_XOFF) ? 0 : APP_UART_XON;
+            s_app_uart_rx_xoff_sent = false;
+        }
+    }
+    if (s_app_uart_rx_flow_char != 0) {
+        // FIFO is full while streaming to target, retried on next ring update and by tx task
+        const char flow_char = s_app_uart_rx_flow_char;
+        if (uart_tx_chars(APP_UART_NUM, &flow_char, 1) == 1) {
+            s_app_uart_rx_flow_char = 0;
+        }
+    }
+    xSemaphoreGive(s_app_uart_rx_flow_lock);
+#endif
+}
 
 /**
- * @addtogroup app_uart_global_funcs
- * @{
+ * @brief removes XON/XOFF of target from received bytes, pausing or resuming writes to target
+ * @param data received bytes
+ * @param len count of received bytes
+ * 
+ * @return count of bytes left
  */
+static size_t app_uart_rx_sw_flow_strip(uint8_t *data, size_t len)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == APP_UART_XOFF) {
+            if (!s_app_uart_tx_xoff) {
+                s_app_uart_tx_xoff_time = esp_timer_get_time();
+                s_app_uart_tx_xoff = true;
+                s_app_uart_rx_stats.xoffs++;
+                xTaskNotifyGive(s_app_uart_flow_task_handle);
+            }
+        } else if (data[i] == APP_UART_XON) {
+            if (s_app_uart_tx_xoff) {
+                s_app_uart_tx_xoff = false;
+                xSemaphoreGive(s_app_uart_tx_xon);
+                xTaskNotifyGive(s_app_uart_flow_task_handle);
+            }
+        } else {
+            data[out++] = data[i];
+        }
+    }
+    return out;
+}
 
 /**
- * @brief initialize app UART interface.
+ * @brief Task which sends XON/XOFF state of target to peer, so host is held off as well
+ * @param pvParameters task parameter
  * 
  */
-int app_uart_init(void)
+static void app_uart_flow_task(void *pvParameters)
 {
-    app_uart_dtr_init();
-    app_uart_ll_init();
-    if(app_uart_tasks_init() != ESP_OK) {
+    bool xoff_sent = false;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // only latest state is sent, an XOFF already followed by XON needs nothing
+        bool target_xoff = s_app_uart_tx_xoff;
+        bool xoff = target_xoff || s_app_uart_tx_held;
+        if (xoff == xoff_sent) {
+            continue;
+        }
+        // a transmit ring filling up holds the peer off like an XOFF of target
+        flow_ctrl_t flow_ctrl = {
+            .xoff = xoff,
+            .time = xoff ? (target_xoff ? s_app_uart_tx_xoff_time : s_app_uart_tx_held_time) : 0,
+        };
+        app_link_flow_ctrl_send(APP_LINK_SESSION_DEFAULT, flow_ctrl);
+        xoff_sent = xoff;
+    }
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief marks UART errors to be sent to peer, without waiting on the link
+ * @param errors SERIAL_STATE_ERRORS bits
+ * 
+ */
+static void app_uart_serial_state_notify(uint16_t errors)
+{
+#if APP_UART_SERIAL_STATE_ENABLE
+    // errors raised while a report is in flight are merged into the next one
+    xTaskNotify(s_app_uart_serial_state_task_handle, errors, eSetBits);
+#endif
+}
+
+#if APP_UART_SERIAL_STATE_ENABLE
+/**
+ * @brief Task which sends UART errors and CTS of target to peer, repeated periodically as carrier for host
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_serial_state_task(void *pvParameters)
+{
+    serial_state_t serial_state;
+    uint8_t cts_sent = 0xff;    // nothing sent yet, first report goes out right away
+    TickType_t sent_tick = 0;
+
+    while (1) {
+        uint32_t errors = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &errors, pdMS_TO_TICKS(APP_UART_SERIAL_STATE_POLL_MS));
+        // CTS is active low, the pin is read whether or not hardware flow control routes it to UART
+        uint8_t cts = (gpio_get_level(APP_UART_GPIO_CTS) == APP_UART_GPIO_RESET);
+        if (errors == 0 && cts == cts_sent && (xTaskGetTickCount() - sent_tick) < pdMS_TO_TICKS(CONFIG_SERIAL_STATE_PERIOD_MS)) {
+            continue;
+        }
+        serial_state.errors = (uint16_t)(errors & SERIAL_STATE_ERRORS);
+        serial_state.cts = cts;
+        app_link_serial_state_send(APP_LINK_SESSION_DEFAULT, serial_state);
+        cts_sent = cts;
+        sent_tick = xTaskGetTickCount();
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+/**
+ * @brief counts a framing error towards detecting bitrate of target again
+ * 
+ */
+static void app_uart_autobaud_frame_error(void)
+{
+#if APP_UART_AUTOBAUD_ENABLE
+    if (!s_app_uart_autobaud_detecting && ++s_app_uart_autobaud_errors == APP_UART_AUTOBAUD_RELOCK_ERRORS) {
+        xTaskNotifyGive(s_app_uart_autobaud_task_handle);
+    }
+#endif
+}
+
+#if APP_UART_AUTOBAUD_ENABLE
+/**
+ * @brief switches UART to detected bitrate
+ * @param bitrate detected bitrate
+ * 
+ */
+static void app_uart_autobaud_lock(uint32_t bitrate)
+{
+    xSemaphoreTake(s_app_uart_config_lock, portMAX_DELAY);
+    s_app_uart_rx_stats.autobaud = bitrate;
+    s_app_uart_rx_stats.autobaud_locks++;
+    if (uart_config.baud_rate != bitrate) {
+        uart_config.baud_rate = bitrate;
+        app_link_send_timeout_update(APP_LINK_SESSION_DEFAULT, uart_config.baud_rate);
+        ESP_ERROR_CHECK(uart_set_baudrate(APP_UART_NUM, uart_config.baud_rate));
+        app_uart_rx_tuning_apply();
+    }
+    xSemaphoreGive(s_app_uart_config_lock);
+}
+
+/**
+ * @brief Task which measures bitrate of target, locks to it and reports it to peer
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_autobaud_task(void *pvParameters)
+{
+    autobaud_t autobaud;
+
+    while (1) {
+        s_app_uart_autobaud_detecting = true;
+        app_uart_autobaud_start(APP_UART_NUM);
+        while (app_uart_autobaud_edges_get(APP_UART_NUM) < APP_UART_AUTOBAUD_EDGES) {
+            vTaskDelay(pdMS_TO_TICKS(APP_UART_AUTOBAUD_POLL_MS));
+        }
+        autobaud.measured = app_uart_autobaud_stop(APP_UART_NUM);
+        autobaud.bitrate = app_uart_autobaud_standard(autobaud.measured);
+        s_app_uart_rx_stats.autobaud_measured = autobaud.measured;
+        if (autobaud.bitrate < APP_UART_AUTOBAUD_BITRATE_MIN) {
+            ESP_LOGE(TAG, "autobaud measured %lu, measuring again", (unsigned long)autobaud.measured);
+            continue;
+        }
+
+        app_uart_autobaud_lock(autobaud.bitrate);
+        s_app_uart_autobaud_errors = 0;
+        s_app_uart_autobaud_detecting = false;
+        ESP_LOGI(TAG, "autobaud locked to %lu, measured %lu", (unsigned long)autobaud.bitrate, (unsigned long)autobaud.measured);
+        autobaud.override = (CONFIG_UART_AUTOBAUD == 2);
+        app_link_autobaud_send(APP_LINK_SESSION_DEFAULT, autobaud);
+
+        // scattered framing errors are noise, the count restarts every second
+        while (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000)) == 0) {
+            s_app_uart_autobaud_errors = 0;
+        }
+        ESP_LOGI(TAG, "autobaud framing errors, measuring again");
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+/**
+ * @brief Task which writes transmit ring to target, waiting for XON and UART in place of link
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_tx_task(void *pvParameters)
+{
+    while (1) {
+        TickType_t wait = pdMS_TO_TICKS(APP_UART_TX_POLL_MS);
+#if APP_UART_RX_BACKPRESSURE
+        // XON or XOFF for target refused by a full FIFO goes out once it has room
+        if (s_app_uart_rx_flow_char != 0) {
+            app_uart_rx_backpressure_update(false);
+            wait = (s_app_uart_rx_flow_char != 0) ? 1 : wait;
+        }
+#endif
+        uint32_t tail = s_app_uart_tx_tail;
+        app_uart_tx_config_check(tail);
+
+        uint32_t len = s_app_uart_tx_head - tail;
+        if (s_app_uart_tx_held && len <= APP_UART_TX_LOW_WATERMARK) {
+            s_app_uart_tx_held = false;
+            xTaskNotifyGive(s_app_uart_flow_task_handle);
+        }
+        if (len == 0) {
+            ulTaskNotifyTake(pdTRUE, wait);
+            continue;
+        }
+        bool sw_flow = (app_uart_sw_flow_status == APP_UART_SW_FLOW_ENABLE);
+        if (sw_flow && s_app_uart_tx_xoff) {
+            // rechecked periodically, flow control may be switched off while target holds XOFF
+            xSemaphoreTake(s_app_uart_tx_xon, wait);
+            continue;
+        }
+
+        // bytes after pending settings wait for them
+        if (s_app_uart_tx_config_pending && (s_app_uart_tx_config_pos - tail) < len) {
+            len = s_app_uart_tx_config_pos - tail;
+        }
+        uint32_t pos = tail & (APP_UART_TX_RING_SIZE - 1);
+        if (len > APP_UART_TX_RING_SIZE - pos) {
+            len = APP_UART_TX_RING_SIZE - pos;
+        }
+        if (sw_flow && len > APP_UART_SW_FLOW_TX_CHUNK) {
+            len = APP_UART_SW_FLOW_TX_CHUNK;
+        } else if (len > APP_UART_TX_WRITE_MAX) {
+            len = APP_UART_TX_WRITE_MAX;
+        }
+        app_uart_tx_bytes(&s_app_uart_tx_ring[pos], len);
+        if (sw_flow) {
+            // each chunk is out before the next, so at most one follows an XOFF of target
+#if APP_UART_DMA_ENABLE
+            app_uart_dma_tx_wait(portMAX_DELAY);
+#else
+            uart_wait_tx_done(APP_UART_NUM, portMAX_DELAY);
+#endif
+        }
+        s_app_uart_tx_tail = tail + len;
+    }
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief applies pending line settings once bytes written before them are sent, or after drain timeout
+ * @param tail transmit ring tail
+ * 
+ */
+static void app_uart_tx_config_check(uint32_t tail)
+{
+    if (!s_app_uart_tx_config_pending) {
+        return;
+    }
+    portENTER_CRITICAL(&s_app_uart_tx_config_lock);
+    config_settings_t config_settings = s_app_uart_tx_config;
+    uint32_t config_pos = s_app_uart_tx_config_pos;
+    int64_t config_time = s_app_uart_tx_config_time;
+    portEXIT_CRITICAL(&s_app_uart_tx_config_lock);
+
+    // a target holding XOFF or CTS cannot hold the switch forever
+    if (tail != config_pos) {
+        if ((esp_timer_get_time() - config_time) < ((int64_t)APP_UART_TX_RING_DRAIN_MS(uart_config.baud_rate) * 1000)) {
+            return;
+        }
+        ESP_LOGE(TAG, "tx ring not drained before reconfiguration");
+    }
+    portENTER_CRITICAL(&s_app_uart_tx_config_lock);
+    // newer settings stay pending for their own bytes
+    if (s_app_uart_tx_config_time == config_time) {
+        s_app_uart_tx_config_pending = false;
+    }
+    portEXIT_CRITICAL(&s_app_uart_tx_config_lock);
+    app_uart_config_apply(config_settings);
+}
+
+/**
+ * @brief hands bytes to UART driver or DMA
+ * @param tx_buf transmit buffer
+ * @param tx_size buffer size
+ * 
+ */
+static void app_uart_tx_bytes(const uint8_t *tx_buf, size_t tx_size)
+{
+#if APP_UART_DMA_ENABLE
+    app_uart_dma_write(tx_buf, tx_size);
+#else
+    /* write */
+    size_t tx_len = tx_size;
+    do {
+        int tx_bytes = uart_write_bytes(APP_UART_NUM, &tx_buf[tx_size-tx_len], tx_len);
+        if(tx_bytes != -1) {
+            tx_len = tx_len - tx_bytes;
+        }
+        if(tx_len != 0) {
+            taskYIELD();
+        }
+    } while(0 != tx_len);
+#endif
+}
+
+/**
+ * @brief applies receive timeout, FIFO threshold and read size of selected profile for current UART settings
+ * 
+ */
+static void app_uart_rx_tuning_apply(void)
+{
+    const app_uart_rx_profile_param_t *param = &s_app_uart_rx_profile_params[s_app_uart_rx_profile];
+
+    // start, data, parity and stop bits, 1.5 stop bits counted as 2
+    uint32_t char_bits = 1 + ((uart_config.data_bits == UART_DATA_BITS_MAX) ? 8 : (5 + uart_config.data_bits));
+    char_bits += (uart_config.parity == UART_PARITY_DISABLE) ? 0 : 1;
+    char_bits += (uart_config.stop_bits == UART_STOP_BITS_1) ? 1 : 2;
+    uint32_t baud_rate = (uart_config.baud_rate > 0) ? uart_config.baud_rate : APP_UART_BAUD_RATE;
+    s_app_uart_rx_char_ns = (uint32_t)(((uint64_t)char_bits * 1000000000ULL) / baud_rate);
+
+    // idle timeout of profile, at least one character as slow lines cannot go shorter
+    uint32_t rx_timeout = (param->timeout_us * 1000) / s_app_uart_rx_char_ns;
+    uint32_t rx_timeout_max = APP_UART_RX_TOUT_BITS_MAX / char_bits;
+    if (rx_timeout < 1) {
+        rx_timeout = 1;
+    } else if (rx_timeout > rx_timeout_max) {
+        rx_timeout = rx_timeout_max;
+    }
+
+    // enough bytes per interrupt to stay under the profile rate, leaving FIFO room for interrupt latency
+    uint32_t chars_per_sec = baud_rate / char_bits;
+    uint32_t rx_full_thresh = (chars_per_sec + param->events_per_sec_max - 1) / param->events_per_sec_max;
+    uint32_t headroom = ((APP_UART_RX_ISR_LATENCY_US * 1000) + s_app_uart_rx_char_ns - 1) / s_app_uart_rx_char_ns;
+    if (headroom < APP_UART_RX_FIFO_HEADROOM_MIN) {
+        headroom = APP_UART_RX_FIFO_HEADROOM_MIN;
+    }
+    uint32_t rx_full_thresh_max = (headroom < UART_FIFO_LEN - 1) ? (UART_FIFO_LEN - headroom) : 1;
+    if (rx_full_thresh < 1) {
+        rx_full_thresh = 1;
+    } else if (rx_full_thresh > rx_full_thresh_max) {
+        rx_full_thresh = rx_full_thresh_max;
+    }
+
+    if (uart_set_rx_timeout(APP_UART_NUM, rx_timeout) != ESP_OK) {
+        ESP_LOGE(TAG, "rx timeout %lu not applied", rx_timeout);
+    }
+    if (uart_set_rx_full_threshold(APP_UART_NUM, rx_full_thresh) != ESP_OK) {
+        ESP_LOGE(TAG, "rx full threshold %lu not applied", rx_full_thresh);
+    }
+
+    // transmit FIFO is refilled before it runs dry during interrupt latency, or the line idles between bytes
+    uint32_t tx_empty_thresh = headroom;
+    if (tx_empty_thresh < APP_UART_TX_EMPTY_THRESH_MIN) {
+        tx_empty_thresh = APP_UART_TX_EMPTY_THRESH_MIN;
+    } else if (tx_empty_thresh > APP_UART_TX_EMPTY_THRESH_MAX) {
+        tx_empty_thresh = APP_UART_TX_EMPTY_THRESH_MAX;
+    }
+    if (uart_set_tx_empty_threshold(APP_UART_NUM, tx_empty_thresh) != ESP_OK) {
+        ESP_LOGE(TAG, "tx empty threshold %lu not applied", tx_empty_thresh);
+    }
+    if (baud_rate > APP_UART_BITRATE_MAX) {
+        ESP_LOGE(TAG, "bitrate %lu above CONFIG_UART_BITRATE_MAX, buffers are sized for %lu", baud_rate, (unsigned long)APP_UART_BITRATE_MAX);
+    }
+    s_app_uart_rx_stats.profile = s_app_uart_rx_profile;
+    s_app_uart_rx_stats.rx_timeout = rx_timeout;
+    s_app_uart_rx_stats.rx_full_thresh = rx_full_thresh;
+    s_app_uart_rx_stats.read_size = param->read_size;
+    s_app_uart_rx_stats.tx_empty_thresh = tx_empty_thresh;
+    ESP_LOGI(TAG, "rx profile %d at %lu baud, timeout %lu chars, full threshold %lu bytes, read size %lu, tx empty threshold %lu bytes",
+             s_app_uart_rx_profile, baud_rate, rx_timeout, rx_full_thresh, param->read_size, tx_empty_thresh);
+}
+
+/**
+ * @brief Task which passes bytes of receive ring to link, waiting on radio in place of UART ingest
+ * @param pvParameters task parameter
+ * 
+ */
+static void IRAM_ATTR app_uart_rx_task(void *pvParameters)
+{
+#if !APP_UART_DMA_ENABLE
+    static const uart_event_t resume = { .type = UART_DATA, .size = 0 };
+#endif
+
+    while (1) {
+        uint32_t tail = s_app_uart_rx_tail;
+        uint32_t occupancy = s_app_uart_rx_head - tail;
+        if (occupancy == 0) {
+            xSemaphoreTake(s_app_uart_rx_data, portMAX_DELAY);
+            continue;
+        }
+
+        // contiguous bytes up to the end of the ring, blocks while link retransmit buffer is full
+        uint32_t pos = tail & (APP_UART_RX_RING_SIZE - 1);
+        size_t len = APP_UART_RX_RING_SIZE - pos;
+        if (len > occupancy) {
+            len = occupancy;
+        }
+        app_link_data_send(APP_LINK_SESSION_DEFAULT, &s_app_uart_rx_ring[pos], len);
+        s_app_uart_rx_tail = tail + len;
+        app_uart_rx_backpressure_update(false);
+
+        if (s_app_uart_rx_stalled) {
+            s_app_uart_rx_stalled = false;
+#if APP_UART_DMA_ENABLE
+            xTaskNotifyGive(s_app_uart_dma_rx_task_handle);
+#else
+            xQueueSend(uart1_queue, &resume, 0);
+#endif
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+#if APP_UART_DMA_ENABLE
+/**
+ * @brief copies bytes into receive ring, as far as it has room
+ * @param data received bytes
+ * @param len count of received bytes
+ * 
+ * @return count of bytes copied
+ */
+static size_t app_uart_rx_ring_put(const uint8_t *data, size_t len)
+{
+    size_t put = 0;
+    uint32_t head = s_app_uart_rx_head;
+
+#if APP_UART_AUTOBAUD_ENABLE
+    if (s_app_uart_autobaud_detecting) {
+        return len;
+    }
+#endif
+    while (put < len) {
+        uint32_t space = APP_UART_RX_RING_SIZE - (head - s_app_uart_rx_tail);
+        if (space == 0) {
+            s_app_uart_rx_stalled = true;
+            // rx task may have drained the ring before it saw the flag
+            if (APP_UART_RX_RING_SIZE - (head - s_app_uart_rx_tail) == 0) {
+                s_app_uart_rx_stats.stalls++;
+                break;
+            }
+            continue;
+        }
+        uint32_t pos = head & (APP_UART_RX_RING_SIZE - 1);
+        size_t n = APP_UART_RX_RING_SIZE - pos;
+        if (n > space) {
+            n = space;
+        }
+        if (n > len - put) {
+            n = len - put;
+        }
+        memcpy(&s_app_uart_rx_ring[pos], &data[put], n);
+        head += n;
+        s_app_uart_rx_head = head;
+        put += n;
+    }
+
+    s_app_uart_rx_stats.bytes_in += put;
+    uint32_t occupancy = head - s_app_uart_rx_tail;
+    if (occupancy > s_app_uart_rx_stats.occupancy_max) {
+        s_app_uart_rx_stats.occupancy_max = occupancy;
+    }
+    xSemaphoreGive(s_app_uart_rx_data);
+    app_uart_rx_backpressure_update(false);
+    return put;
+}
+
+/**
+ * @brief Task which copies DMA receive buffers into receive ring
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_dma_rx_task(void *pvParameters)
+{
+    uint8_t *data;
+
+    while (1) {
+        size_t len = app_uart_dma_rx_get(&data, portMAX_DELAY);
+        size_t put = 0;
+        if (app_uart_sw_flow_status == APP_UART_SW_FLOW_ENABLE) {
+            len = app_uart_rx_sw_flow_strip(data, len);
+        }
+        while (put < len) {
+            put += app_uart_rx_ring_put(&data[put], len - put);
+            if (put < len) {
+                // buffer stays held, DMA stops once the others fill and RTS holds the sender off
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+        }
+        app_uart_dma_rx_release();
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+#if CONFIG_STATS_LOG_PERIOD_MS
+/**
+ * @brief Task which logs receive ring statistics and receive latency periodically
+ * @param pvParameters task parameter
+ * 
+ */
+static void app_uart_stats_task(void *pvParameters)
+{
+    app_uart_rx_stats_t stats;
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_STATS_LOG_PERIOD_MS));
+        app_uart_rx_stats_get(&stats);
+        ESP_LOGI(TAG, "rx ring: %lu/%lu bytes, max: %lu, in: %lu, stalls: %lu, fifo overflows: %lu, buffer full: %lu, holds: %lu",
+                 (unsigned long)stats.occupancy, (unsigned long)stats.size, (unsigned long)stats.occupancy_max,
+                 (unsigned long)stats.bytes_in, (unsigned long)stats.stalls, (unsigned long)stats.fifo_overflows,
+                 (unsigned long)stats.buffer_full, (unsigned long)stats.holds);
+        ESP_LOGI(TAG, "rx profile: %lu, timeout: %lu, thresh: %lu, events: %lu/s, latency: %lu us avg, %lu us max",
+                 (unsigned long)stats.profile, (unsigned long)stats.rx_timeout, (unsigned long)stats.rx_full_thresh,
+                 (unsigned long)stats.events_per_sec, (unsigned long)stats.latency_us_avg, (unsigned long)stats.latency_us_max);
+        if (stats.delimiter >= 0) {
+            ESP_LOGI(TAG, "rx delimiter 0x%02x events: %lu", (unsigned int)stats.delimiter, (unsigned long)stats.delimiter_events);
+        }
+#if APP_UART_DMA_ENABLE
+        app_uart_dma_stats_t dma_stats;
+        app_uart_dma_stats_get(&dma_stats);
+        ESP_LOGI(TAG, "dma rx: %lu bytes in %lu buffers, stalls: %lu, tx: %lu bytes in %lu buffers",
+                 (unsigned long)dma_stats.rx_bytes, (unsigned long)dma_stats.rx_buffers, (unsigned long)dma_stats.rx_stalls,
+                 (unsigned long)dma_stats.tx_bytes, (unsigned long)dma_stats.tx_buffers);
+#endif
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+/**
+ * @brief initialize app UART tasks.
+ * 
+ * @return error code
+ */
+static int app_uart_tasks_init(void)
+{
+    s_app_uart_rx_data = xSemaphoreCreateBinary();
+    if (s_app_uart_rx_data == NULL) {
+        ESP_LOGE(TAG, "Create semaphore fail");
+        return ESP_FAIL;
+    }
+    s_app_uart_rx_stats.size = APP_UART_RX_RING_SIZE;
+    s_app_uart_rx_stats.tx_size = APP_UART_TX_RING_SIZE;
+    s_app_uart_tx_xon = xSemaphoreCreateBinary();
+    if (s_app_uart_tx_xon == NULL) {
+        ESP_LOGE(TAG, "Create semaphore fail");
+        return ESP_FAIL;
+    }
+#if APP_UART_RX_BACKPRESSURE
+    s_app_uart_rx_flow_lock = xSemaphoreCreateMutex();
+    if (s_app_uart_rx_flow_lock == NULL) {
+        ESP_LOGE(TAG, "Create mutex fail");
+        return ESP_FAIL;
+    }
+#endif
+
+    xTaskCreate(app_uart_flow_task, "app_uart_flow_task", 2048, NULL, 4, &s_app_uart_flow_task_handle);
+    xTaskCreate(app_uart_tx_task, "app_uart_tx_task", 4096, NULL, 3, &s_app_uart_tx_task_handle);
+#if APP_UART_AUTOBAUD_ENABLE
+    s_app_uart_config_lock = xSemaphoreCreateMutex();
+    if (s_app_uart_config_lock == NULL) {
+        ESP_LOGE(TAG, "Create mutex fail");
         return ESP_FAIL;
     }
+    xTaskCreate(app_uart_autobaud_task, "app_uart_autobaud_task", 2048, NULL, 4, &s_app_uart_autobaud_task_handle);
+#endif
+#if APP_UART_SERIAL_STATE_ENABLE
+    xTaskCreate(app_uart_serial_state_task, "app_uart_serial_state_task", 2048, NULL, 4, &s_app_uart_serial_state_task_handle);
+#endif
+    // Create a task to handle uart event from ISR, above rx task so ingest runs while link waits
+    xTaskCreate(app_uart_event_task, "app_uart_event_task", 4096, NULL, 4, NULL);
+    xTaskCreate(app_uart_rx_task, "app_uart_rx_task", 4096, NULL, 3, NULL);
+#if APP_UART_DMA_ENABLE
+    xTaskCreate(app_uart_dma_rx_task, "app_uart_dma_rx_task", 2048, NULL, 4, &s_app_uart_dma_rx_task_handle);
+#endif
+#if CONFIG_STATS_LOG_PERIOD_MS
+    xTaskCreate(app_uart_stats_task, "app_uart_stats_task", 2048, NULL, 1, NULL);
+#endif
+
     return ESP_OK;
 
 }
 
 /**
- * @brief reconfigures UART configuration.
+ * @brief applies UART line settings
  * @param config_settings UART configuration settings
  * 
  */
-void app_uart_config_reset(config_settings_t config_settings)
+static void app_uart_config_apply(config_settings_t config_settings)
 {
+    // bytes written before the switch leave at the old settings, a stalled CTS cannot hold the switch forever
+#if APP_UART_DMA_ENABLE
+    if(app_uart_dma_tx_wait(pdMS_TO_TICKS(APP_UART_TX_DRAIN_MS(uart_config.baud_rate))) != ESP_OK) {
+        ESP_LOGE(TAG, "dma tx not drained before reconfiguration");
+    }
+#endif
+    if(uart_wait_tx_done(APP_UART_NUM, pdMS_TO_TICKS(APP_UART_TX_DRAIN_MS(uart_config.baud_rate))) != ESP_OK) {
+        ESP_LOGE(TAG, "tx not drained before reconfiguration");
+    }
+
+#if APP_UART_AUTOBAUD_ENABLE
+    xSemaphoreTake(s_app_uart_config_lock, portMAX_DELAY);
+#endif
     uart_config.baud_rate = config_settings.bitrate;
+#if APP_UART_AUTOBAUD_ENABLE
+    // host bitrate applies until target bitrate is detected
+    if (CONFIG_UART_AUTOBAUD == 2 && s_app_uart_rx_stats.autobaud != 0) {
+        uart_config.baud_rate = s_app_uart_rx_stats.autobaud;
+    }
+#endif
     switch(config_settings.data_bits) {
         case 5:
         {
@@ -413,9 +1498,12 @@ void app_uart_config_reset(config_settings_t config_settings)
         uart_config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
     }
 
-    app_espnow_send_timeout = (uint32_t)((APP_ESPNOW_SEND_DATA_SIZE*8*1000)/uart_config.baud_rate) + (uint32_t)(1000/uart_config.baud_rate) + 20;
-    ESP_LOGE(TAG, "app_espnow_send_timeout: %lu", app_espnow_send_timeout);
+    app_link_send_timeout_update(APP_LINK_SESSION_DEFAULT, uart_config.baud_rate);
     ESP_ERROR_CHECK(uart_param_config(APP_UART_NUM, &uart_config));
+    app_uart_rx_tuning_apply();
+#if APP_UART_AUTOBAUD_ENABLE
+    xSemaphoreGive(s_app_uart_config_lock);
+#endif
 
     if(app_uart_hw_flow_status != config_settings.hw_flow_status) {
         app_uart_hw_flow_status = config_settings.hw_flow_status;
@@ -427,7 +1515,56 @@ void app_uart_config_reset(config_settings_t config_settings)
             app_conn_on(HW_FLOW_DIS_CONN_ON_PERIOD, HW_FLOW_DIS_CONN_OFF_PERIOD, HW_FLOW_DIS_APP_CONN_ON_COUNT);
         }
     }
+    app_uart_sw_flow_status = config_settings.sw_flow_status ? APP_UART_SW_FLOW_ENABLE : APP_UART_SW_FLOW_DISABLE;
+    if(app_uart_sw_flow_status == APP_UART_SW_FLOW_DISABLE && s_app_uart_tx_xoff) {
+        // an XOFF of target no longer applies, peer is released as well
+        s_app_uart_tx_xoff = false;
+        xSemaphoreGive(s_app_uart_tx_xon);
+        xTaskNotifyGive(s_app_uart_flow_task_handle);
+    }
 
+    // new settings restore hardware RTS, a sender held off stays held off
+    app_uart_rx_backpressure_update(true);
+
+}
+
+/** @} */ // End of app_uart_static_funcs group
+
+/**
+ * @addtogroup app_uart_global_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize app UART interface.
+ * 
+ */
+int app_uart_init(void)
+{
+    app_uart_dtr_init();
+    app_uart_ll_init();
+    if(app_uart_tasks_init() != ESP_OK) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+
+}
+
+/**
+ * @brief reconfigures UART configuration once bytes written at the old settings are sent.
+ * @param config_settings UART configuration settings
+ * 
+ */
+void app_uart_config_reset(config_settings_t config_settings)
+{
+    // applied by tx task behind bytes already in transmit ring, link does not wait for them
+    portENTER_CRITICAL(&s_app_uart_tx_config_lock);
+    s_app_uart_tx_config = config_settings;
+    s_app_uart_tx_config_pos = s_app_uart_tx_head;
+    s_app_uart_tx_config_time = esp_timer_get_time();
+    s_app_uart_tx_config_pending = true;
+    portEXIT_CRITICAL(&s_app_uart_tx_config_lock);
+    xTaskNotifyGive(s_app_uart_tx_task_handle);
 }
 
 /**
@@ -438,18 +1575,41 @@ void app_uart_config_reset(config_settings_t config_settings)
  */
 void app_uart_write(const uint8_t *tx_buf, size_t tx_size)
 {
-    /* write */
-    size_t tx_len = tx_size;
-    do {
-        int tx_bytes = uart_write_bytes(APP_UART_NUM, &tx_buf[tx_size-tx_len], tx_len);
-        if(tx_bytes != -1) {
-            tx_len = tx_len - tx_bytes;
-        }
-        if(tx_len != 0) {
-            taskYIELD();
-        }
-    } while(0 != tx_len);
-    taskYIELD();
+    // only copied here, link keeps acknowledging while target holds off and the peer is held by flow control,
+    // frames without room were refused by the link with app_uart_tx_space_get before, so nothing is dropped
+    uint32_t head = s_app_uart_tx_head;
+    uint32_t space = APP_UART_TX_RING_SIZE - (head - s_app_uart_tx_tail);
+    if (tx_size > space) {
+        ESP_LOGE(TAG, "tx ring overrun, write of %u bytes with %lu free", (unsigned)tx_size, (unsigned long)space);
+        tx_size = space;
+    }
+    uint32_t pos = head & (APP_UART_TX_RING_SIZE - 1);
+    size_t first = APP_UART_TX_RING_SIZE - pos;
+    if (first > tx_size) {
+        first = tx_size;
+    }
+    memcpy(&s_app_uart_tx_ring[pos], tx_buf, first);
+    memcpy(s_app_uart_tx_ring, &tx_buf[first], tx_size - first);
+    s_app_uart_tx_head = head + tx_size;
+
+    // peer may still send what its link stream holds, room for it is left above high watermark
+    if (!s_app_uart_tx_held && (s_app_uart_tx_head - s_app_uart_tx_tail) >= APP_UART_TX_HIGH_WATERMARK) {
+        s_app_uart_tx_held_time = esp_timer_get_time();
+        s_app_uart_tx_held = true;
+        s_app_uart_rx_stats.tx_holds++;
+        xTaskNotifyGive(s_app_uart_flow_task_handle);
+    }
+    xTaskNotifyGive(s_app_uart_tx_task_handle);
+}
+
+/**
+ * @brief free space of transmit ring, app_uart_write of up to this many bytes takes them all
+ * 
+ * @return free space in bytes
+ */
+size_t app_uart_tx_space_get(void)
+{
+    return APP_UART_TX_RING_SIZE - (s_app_uart_tx_head - s_app_uart_tx_tail);
 }
 
 /**
@@ -490,6 +1650,34 @@ void app_uart_rts_set(uint8_t rts_state)
     }
 }
 
+/**
+ * @brief receive ring statistics, resets highest occupancy, interrupt rate and latency
+ * @param stats receive ring statistics
+ * 
+ */
+void app_uart_rx_stats_get(app_uart_rx_stats_t *stats)
+{
+    static int64_t last_time = 0;
+    static uint32_t last_events = 0;
+    int64_t now = esp_timer_get_time();
+
+    *stats = s_app_uart_rx_stats;
+    stats->occupancy = s_app_uart_rx_head - s_app_uart_rx_tail;
+    stats->tx_occupancy = s_app_uart_tx_head - s_app_uart_tx_tail;
+    if (last_time != 0 && now > last_time) {
+        stats->events_per_sec = (uint32_t)(((uint64_t)(stats->events - last_events) * 1000000) / (now - last_time));
+    }
+    if (s_app_uart_rx_latency_events > 0) {
+        stats->latency_us_avg = (uint32_t)(s_app_uart_rx_latency_us_sum / s_app_uart_rx_latency_events);
+    }
+    last_time = now;
+    last_events = stats->events;
+    s_app_uart_rx_latency_us_sum = 0;
+    s_app_uart_rx_latency_events = 0;
+    s_app_uart_rx_stats.latency_us_max = 0;
+    s_app_uart_rx_stats.occupancy_max = stats->occupancy;
+}
+
 /** @} */ // End of app_uart_global_funcs group
 
 /** @} */ // End of app_uart group
@@ -61,6 +61,19 @@ typedef enum {
     APP_UART_HW_FLOW_ENABLE,
 } app_usb_hw_flow_status_t;
 
+typedef enum {
+    APP_UART_SW_FLOW_DISABLE=0,
+    APP_UART_SW_FLOW_ENABLE,
+} app_uart_sw_flow_status_t;
+
+/* receive tuning, values of CONFIG_UART_RX_PROFILE */
+typedef enum {
+    APP_UART_RX_PROFILE_LATENCY=0,      /**< bytes reach the link soon after the line goes idle, more interrupts */
+    APP_UART_RX_PROFILE_BALANCED,
+    APP_UART_RX_PROFILE_THROUGHPUT,     /**< fewest interrupts, bytes may wait several milliseconds */
+    APP_UART_RX_PROFILE_MAX,
+} app_uart_rx_profile_t;
+
 /** @} */ // End of app_uart_define group
 
 
@@ -82,6 +95,40 @@ typedef struct {
     };
 } app_uart_evt_config_t;
 
+/* receive ring between UART driver (producer) and link (consumer), counters wrap */
+typedef struct {
+    uint32_t size;              /**< ring size in bytes */
+    uint32_t occupancy;         /**< bytes waiting for link */
+    uint32_t occupancy_max;     /**< highest occupancy since last read */
+    uint32_t bytes_in;          /**< bytes read from UART driver */
+    uint32_t stalls;            /**< times ring was full and bytes were left in UART driver */
+    uint32_t fifo_overflows;    /**< UART hardware FIFO overflows, bytes lost before the driver */
+    uint32_t buffer_full;       /**< UART driver buffer full events, receiving paused until ring drains */
+    uint32_t profile;           /**< receive profile, app_uart_rx_profile_t */
+    uint32_t rx_timeout;        /**< idle time raising receive interrupt, in characters */
+    uint32_t rx_full_thresh;    /**< FIFO bytes raising receive interrupt */
+    uint32_t read_size;         /**< largest single read from UART driver in bytes */
+    uint32_t tx_empty_thresh;   /**< FIFO bytes below which transmit interrupt refills it */
+    uint32_t events;            /**< receive interrupts serviced */
+    uint32_t events_per_sec;    /**< receive interrupt rate since last read */
+    uint32_t latency_us_avg;    /**< mean measured time of first byte of an interrupt from its start bit to ring, since last read */
+    uint32_t latency_us_max;    /**< longest measured time of first byte of an interrupt since last read */
+    uint32_t holds;             /**< times sender was held off at high watermark */
+    uint32_t held;              /**< 1 while sender is held off */
+    uint32_t xoffs;             /**< XOFF received from target, with XON/XOFF flow control */
+    uint32_t breaks;            /**< breaks received from target */
+    uint32_t parity_errors;     /**< characters received with parity error */
+    uint32_t frame_errors;      /**< characters received with framing error */
+    uint32_t autobaud;          /**< bitrate locked to by auto-baud, 0 until locked */
+    uint32_t autobaud_measured; /**< bitrate measured by auto-baud */
+    uint32_t autobaud_locks;    /**< times auto-baud locked to a bitrate */
+    uint32_t tx_size;           /**< transmit ring size in bytes */
+    uint32_t tx_occupancy;      /**< bytes from link waiting for target */
+    uint32_t tx_holds;          /**< times peer was held off at transmit ring high watermark */
+    int32_t delimiter;          /**< byte passing received bytes to link at once, -1 when none */
+    uint32_t delimiter_events;  /**< receive events ended by delimiter before idle timeout */
+} app_uart_rx_stats_t;
+
 /** @} */ // End of app_uart_types group
 
 /**
@@ -95,7 +142,7 @@ typedef struct {
  */
 int app_uart_init(void);
 /**
- * @brief reconfigures UART configuration.
+ * @brief reconfigures UART configuration once bytes written at the old settings are sent.
  * @param config_settings UART configuration settings
  * 
  */
@@ -107,6 +154,12 @@ void app_uart_config_reset(config_settings_t config_settings);
  * 
  */
 void app_uart_write(const uint8_t *tx_buf, size_t tx_size);
+/**
+ * @brief free space of transmit ring, app_uart_write of up to this many bytes takes them all
+ * 
+ * @return free space in bytes
+ */
+size_t app_uart_tx_space_get(void);
 /**
  * @brief set DTR level
  * @param dtr_state DTR level
@@ -119,6 +172,12 @@ void app_uart_dtr_set(uint8_t dtr_state);
  * 
  */
 void app_uart_rts_set(uint8_t rts_state);
+/**
+ * @brief receive ring statistics, resets highest occupancy, interrupt rate and latency
+ * @param stats receive ring statistics
+ * 
+ */
+void app_uart_rx_stats_get(app_uart_rx_stats_t *stats);
 
 /** @} */ // End of app_uart_global_funcs group
 
@@ -0,0 +1,149 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_uart_autobaud.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application UART auto-baud module, UART pulse counters measure bit time of target on RX
+ */
+
+/**
+ * @defgroup app_uart_autobaud Application UART Auto-baud Module
+ * @brief Module for measuring bitrate of target from bit timing on UART RX
+ * @{
+ */
+
+/**
+ * @addtogroup app_uart_autobaud_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "esp_private/esp_clk.h"
+#include "hal/uart_ll.h"
+#include "config.h"
+#include "commons.h"
+#include "app_uart_autobaud.h"
+
+/** @} */ // End of app_uart_autobaud_include group
+
+#if APP_UART_AUTOBAUD_ENABLE
+/**
+ * @addtogroup app_uart_autobaud_define
+ * @{
+ */
+
+/* measured bitrate within this many percent of a standard bitrate is taken as that one */
+#define APP_UART_AUTOBAUD_TOLERANCE     4
+/* pulses shorter than this many APB cycles are glitches, not bits, 20 Mbaud at 80 MHz */
+#define APP_UART_AUTOBAUD_PULSE_MIN     4
+
+/** @} */ // End of app_uart_autobaud_define group
+
+/**
+ * @addtogroup app_uart_autobaud_static_vars
+ * @{
+ */
+
+static const uint32_t s_app_uart_autobaud_standards[] = {
+    1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 74880, 76800, 115200, 128000, 153600,
+    230400, 250000, 256000, 460800, 500000, 576000, 921600, 1000000, 1152000, 1500000, 2000000,
+    2500000, 3000000, 3500000, 4000000, 5000000,
+};
+
+/** @} */ // End of app_uart_autobaud_static_vars group
+
+/**
+ * @addtogroup app_uart_autobaud_global_funcs
+ * @{
+ */
+
+/**
+ * @brief clears auto-baud counters of UART and starts measuring RX
+ * @param uart_num UART number
+ * 
+ */
+void app_uart_autobaud_start(int uart_num)
+{
+    uart_dev_t *hw = UART_LL_GET_HW(uart_num);
+    // counters are cleared while detection is off
+    uart_ll_set_autobaud_en(hw, false);
+    uart_ll_set_autobaud_en(hw, true);
+}
+
+/**
+ * @brief edges seen on RX since measuring started
+ * @param uart_num UART number
+ * 
+ * @return count of edges
+ */
+uint32_t app_uart_autobaud_edges_get(int uart_num)
+{
+    return uart_ll_get_rxd_edge_cnt(UART_LL_GET_HW(uart_num));
+}
+
+/**
+ * @brief stops measuring RX and computes bitrate from shortest pulses
+ * @param uart_num UART number
+ * 
+ * @return measured bitrate in bits per second, 0 if no pulse was measured
+ */
+uint32_t app_uart_autobaud_stop(int uart_num)
+{
+    uart_dev_t *hw = UART_LL_GET_HW(uart_num);
+    uint32_t low = uart_ll_get_low_pulse_cnt(hw);
+    uint32_t high = uart_ll_get_high_pulse_cnt(hw);
+    uart_ll_set_autobaud_en(hw, false);
+
+    if (low < APP_UART_AUTOBAUD_PULSE_MIN || high < APP_UART_AUTOBAUD_PULSE_MIN) {
+        return 0;
+    }
+    // edges are sampled, low pulses read short and high pulses long by about one cycle, their mean is one bit
+    uint32_t bit_cycles = (low + high + 2) / 2;
+    return (uint32_t)esp_clk_apb_freq() / bit_cycles;
+}
+
+/**
+ * @brief nearest standard bitrate to measured one
+ * @param measured measured bitrate in bits per second
+ * 
+ * @return standard bitrate within tolerance, else measured bitrate
+ */
+uint32_t app_uart_autobaud_standard(uint32_t measured)
+{
+    for (size_t i = 0; i < sizeof(s_app_uart_autobaud_standards) / sizeof(s_app_uart_autobaud_standards[0]); i++) {
+        uint32_t standard = s_app_uart_autobaud_standards[i];
+        uint32_t diff = (measured > standard) ? (measured - standard) : (standard - measured);
+        if ((uint64_t)diff * 100 <= (uint64_t)standard * APP_UART_AUTOBAUD_TOLERANCE) {
+            return standard;
+        }
+    }
+    return measured;
+}
+
+/** @} */ // End of app_uart_autobaud_global_funcs group
+#endif
+
+/** @} */ // End of app_uart_autobaud module
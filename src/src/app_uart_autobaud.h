@@ -0,0 +1,103 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_uart_autobaud.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application UART auto-baud header
+ */
+
+#ifndef APP_UART_AUTOBAUD_H
+#define APP_UART_AUTOBAUD_H
+
+/**
+ * @defgroup app_uart_autobaud Application UART Auto-baud Module
+ * @brief Module for measuring bitrate of target from bit timing on UART RX
+ * @{
+ */
+
+/**
+ * @addtogroup app_uart_autobaud_include
+ * @{
+ */
+
+#include <stdint.h>
+#include "config.h"
+#include "commons.h"
+/** @} */ // End of app_uart_autobaud_include group
+
+/**
+ * @addtogroup app_uart_autobaud_define
+ * @{
+ */
+
+/* 1 if WiSer-UART detects bitrate of its target */
+#if (DEVICE_CONFIG_MODE == DEVICE_CONFIG_MODE_UART) && CONFIG_UART_AUTOBAUD
+#define APP_UART_AUTOBAUD_ENABLE    1
+#else
+#define APP_UART_AUTOBAUD_ENABLE    0
+#endif
+
+/** @} */ // End of app_uart_autobaud_define group
+
+#if APP_UART_AUTOBAUD_ENABLE
+/**
+ * @addtogroup app_uart_autobaud_global_funcs
+ * @{
+ */
+
+/**
+ * @brief clears auto-baud counters of UART and starts measuring RX
+ * @param uart_num UART number
+ * 
+ */
+void app_uart_autobaud_start(int uart_num);
+/**
+ * @brief edges seen on RX since measuring started
+ * @param uart_num UART number
+ * 
+ * @return count of edges
+ */
+uint32_t app_uart_autobaud_edges_get(int uart_num);
+/**
+ * @brief stops measuring RX and computes bitrate from shortest pulses
+ * @param uart_num UART number
+ * 
+ * @return measured bitrate in bits per second, 0 if no pulse was measured
+ */
+uint32_t app_uart_autobaud_stop(int uart_num);
+/**
+ * @brief nearest standard bitrate to measured one
+ * @param measured measured bitrate in bits per second
+ * 
+ * @return standard bitrate within tolerance, else measured bitrate
+ */
+uint32_t app_uart_autobaud_standard(uint32_t measured);
+
+/** @} */ // End of app_uart_autobaud_global_funcs group
+#endif
+
+/** @} */ // End of app_uart_autobaud group
+
+#endif  // End of APP_UART_AUTOBAUD_H
@@ -0,0 +1,418 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_uart_dma.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application UART DMA module, UHCI moves UART data to and from linked DMA buffers
+ */
+
+/**
+ * @defgroup app_uart_dma Application UART DMA Module
+ * @brief Module for moving UART data through UHCI DMA buffers instead of FIFO interrupts
+ * @{
+ */
+
+/**
+ * @addtogroup app_uart_dma_include
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "esp_intr_alloc.h"
+#include "esp_private/periph_ctrl.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "soc/periph_defs.h"
+#include "soc/lldesc.h"
+#include "soc/uhci_struct.h"
+#include "soc/uhci_reg.h"
+#include "soc/uart_struct.h"
+#include "config.h"
+#include "commons.h"
+#include "app_uart_dma.h"
+
+/** @} */ // End of app_uart_dma_include group
+
+#if APP_UART_DMA_ENABLE
+/**
+ * @addtogroup app_uart_dma_define
+ * @{
+ */
+
+#define APP_UART_DMA_BUF_SIZE       CONFIG_UART_DMA_BUF_SIZE
+#define APP_UART_DMA_RX_BUF_COUNT   CONFIG_UART_DMA_RX_BUF_COUNT
+/* ping-pong, DMA sends one while the other is filled */
+#define APP_UART_DMA_TX_BUF_COUNT   2
+
+#if (APP_UART_DMA_BUF_SIZE % 4) != 0 || APP_UART_DMA_BUF_SIZE > 4092
+#error CONFIG_UART_DMA_BUF_SIZE must be multiple of 4 up to 4092!
+#endif
+#if APP_UART_DMA_RX_BUF_COUNT < 2
+#error CONFIG_UART_DMA_RX_BUF_COUNT must be at least 2!
+#endif
+
+/* receive buffer ends early once line is idle for this many bit times, short bursts reach the link without waiting for a full buffer */
+#define APP_UART_DMA_RX_IDLE_BITS   30
+
+/* descriptor address register holds low 20 bits of internal memory address */
+#define APP_UART_DMA_LINK_ADDR(desc)    ((uint32_t)(desc) & 0xFFFFF)
+
+#define APP_UART_DMA_RX_INTR        (UHCI_IN_DONE_INT_ENA | UHCI_IN_SUC_EOF_INT_ENA)
+#define APP_UART_DMA_RX_STALL_INTR  (UHCI_IN_DSCR_EMPTY_INT_ENA | UHCI_IN_DSCR_ERR_INT_ENA)
+#define APP_UART_DMA_TX_INTR        (UHCI_OUT_TOTAL_EOF_INT_ENA)
+
+/** @} */ // End of app_uart_dma_define group
+
+/**
+ * @addtogroup app_uart_dma_static_vars
+ * @{
+ */
+/** @brief Tag for logging */
+static const char *TAG = "app_uart_dma";
+
+/* receive descriptors form a ring, DMA owns a descriptor until it completes it */
+static DMA_ATTR lldesc_t s_app_uart_dma_rx_desc[APP_UART_DMA_RX_BUF_COUNT];
+static DMA_ATTR uint8_t s_app_uart_dma_rx_buf[APP_UART_DMA_RX_BUF_COUNT][APP_UART_DMA_BUF_SIZE];
+/* completed descriptors in order, read one at a time */
+static QueueHandle_t s_app_uart_dma_rx_queue = NULL;
+/* next descriptor DMA completes, only moved by ISR */
+static uint8_t s_app_uart_dma_rx_next = 0;
+/* descriptors completed and not yet handed back */
+static volatile uint8_t s_app_uart_dma_rx_pending = 0;
+/* descriptor being read, APP_UART_DMA_RX_BUF_COUNT when none */
+static uint8_t s_app_uart_dma_rx_held = APP_UART_DMA_RX_BUF_COUNT;
+/* set by ISR when DMA ran out of descriptors, cleared when one is handed back */
+static volatile bool s_app_uart_dma_rx_stalled = false;
+
+static DMA_ATTR lldesc_t s_app_uart_dma_tx_desc[APP_UART_DMA_TX_BUF_COUNT];
+static DMA_ATTR uint8_t s_app_uart_dma_tx_buf[APP_UART_DMA_TX_BUF_COUNT][APP_UART_DMA_BUF_SIZE];
+/* counts transmit buffers free to fill */
+static SemaphoreHandle_t s_app_uart_dma_tx_free = NULL;
+/* transmit buffers are filled and sent in order, head is next to fill and tail is being sent */
+static uint8_t s_app_uart_dma_tx_head = 0;
+static uint8_t s_app_uart_dma_tx_tail = 0;
+static volatile uint8_t s_app_uart_dma_tx_queued = 0;
+
+static portMUX_TYPE s_app_uart_dma_lock = portMUX_INITIALIZER_UNLOCKED;
+static intr_handle_t s_app_uart_dma_intr = NULL;
+static app_uart_dma_stats_t s_app_uart_dma_stats;
+
+/** @} */ // End of app_uart_dma_static_vars group
+
+/**
+ * @addtogroup app_uart_dma_static_funcs
+ * @{
+ */
+
+/**
+ * @brief starts receive link at descriptor
+ * @param index descriptor index
+ * 
+ */
+static void app_uart_dma_rx_start(uint8_t index);
+
+/**
+ * @brief starts transmit link at descriptor
+ * @param index descriptor index
+ * 
+ */
+static void app_uart_dma_tx_start(uint8_t index);
+
+/**
+ * @brief UHCI interrupt, hands completed receive descriptors to reader and starts next queued transmit buffer
+ * @param arg unused
+ * 
+ */
+static void app_uart_dma_isr(void *arg);
+
+/** @} */ // End of app_uart_dma_static_funcs group
+
+/**
+ * @addtogroup app_uart_dma_static_funcs
+ * @{
+ */
+
+/**
+ * @brief starts receive link at descriptor
+ * @param index descriptor index
+ * 
+ */
+static void IRAM_ATTR app_uart_dma_rx_start(uint8_t index)
+{
+    UHCI0.dma_in_link.addr = APP_UART_DMA_LINK_ADDR(&s_app_uart_dma_rx_desc[index]);
+    UHCI0.dma_in_link.start = 1;
+}
+
+/**
+ * @brief starts transmit link at descriptor
+ * @param index descriptor index
+ * 
+ */
+static void IRAM_ATTR app_uart_dma_tx_start(uint8_t index)
+{
+    UHCI0.dma_out_link.addr = APP_UART_DMA_LINK_ADDR(&s_app_uart_dma_tx_desc[index]);
+    UHCI0.dma_out_link.start = 1;
+}
+
+/**
+ * @brief UHCI interrupt, hands completed receive descriptors to reader and starts next queued transmit buffer
+ * @param arg unused
+ * 
+ */
+static void IRAM_ATTR app_uart_dma_isr(void *arg)
+{
+    BaseType_t high_task_wakeup = pdFALSE;
+    uint32_t status = UHCI0.int_st.val;
+    UHCI0.int_clr.val = status;
+
+    portENTER_CRITICAL_ISR(&s_app_uart_dma_lock);
+    if (status & (APP_UART_DMA_RX_INTR | APP_UART_DMA_RX_STALL_INTR)) {
+        // one interrupt may cover several descriptors, take every completed one in order
+        while (s_app_uart_dma_rx_pending < APP_UART_DMA_RX_BUF_COUNT) {
+            lldesc_t *desc = &s_app_uart_dma_rx_desc[s_app_uart_dma_rx_next];
+            if (desc->owner || desc->length == 0) {
+                break;
+            }
+            uint8_t index = s_app_uart_dma_rx_next;
+            s_app_uart_dma_rx_pending++;
+            s_app_uart_dma_stats.rx_bytes += desc->length;
+            s_app_uart_dma_stats.rx_buffers++;
+            s_app_uart_dma_rx_next = (s_app_uart_dma_rx_next + 1) % APP_UART_DMA_RX_BUF_COUNT;
+            xQueueSendFromISR(s_app_uart_dma_rx_queue, &index, &high_task_wakeup);
+        }
+    }
+    if (status & APP_UART_DMA_RX_STALL_INTR) {
+        // UART FIFO fills and RTS holds the sender off until a descriptor is handed back
+        s_app_uart_dma_rx_stalled = true;
+        s_app_uart_dma_stats.rx_stalls++;
+    }
+    if ((status & APP_UART_DMA_TX_INTR) && s_app_uart_dma_tx_queued > 0) {
+        s_app_uart_dma_stats.tx_bytes += s_app_uart_dma_tx_desc[s_app_uart_dma_tx_tail].length;
+        s_app_uart_dma_stats.tx_buffers++;
+        s_app_uart_dma_tx_tail = (s_app_uart_dma_tx_tail + 1) % APP_UART_DMA_TX_BUF_COUNT;
+        s_app_uart_dma_tx_queued--;
+        if (s_app_uart_dma_tx_queued > 0) {
+            app_uart_dma_tx_start(s_app_uart_dma_tx_tail);
+        }
+        xSemaphoreGiveFromISR(s_app_uart_dma_tx_free, &high_task_wakeup);
+    }
+    portEXIT_CRITICAL_ISR(&s_app_uart_dma_lock);
+
+    if (high_task_wakeup == pdTRUE) {
+        portYIELD_FROM_ISR(high_task_wakeup);
+    }
+}
+
+/** @} */ // End of app_uart_dma_static_funcs group
+
+/**
+ * @addtogroup app_uart_dma_global_funcs
+ * @{
+ */
+
+/**
+ * @brief attaches UHCI DMA to UART, after UART driver is installed and its receive interrupts are disabled
+ * @param uart_num UART number
+ * 
+ * @return error code
+ */
+int app_uart_dma_init(int uart_num)
+{
+    s_app_uart_dma_rx_queue = xQueueCreate(APP_UART_DMA_RX_BUF_COUNT, sizeof(uint8_t));
+    s_app_uart_dma_tx_free = xSemaphoreCreateCounting(APP_UART_DMA_TX_BUF_COUNT, APP_UART_DMA_TX_BUF_COUNT);
+    if (s_app_uart_dma_rx_queue == NULL || s_app_uart_dma_tx_free == NULL) {
+        ESP_LOGE(TAG, "Create queue fail");
+        return ESP_FAIL;
+    }
+
+    for (uint8_t i = 0; i < APP_UART_DMA_RX_BUF_COUNT; i++) {
+        lldesc_t *desc = &s_app_uart_dma_rx_desc[i];
+        desc->size = APP_UART_DMA_BUF_SIZE;
+        desc->length = 0;
+        desc->offset = 0;
+        desc->sosf = 0;
+        desc->eof = 0;
+        desc->owner = 1;
+        desc->buf = s_app_uart_dma_rx_buf[i];
+        desc->qe.stqe_next = &s_app_uart_dma_rx_desc[(i + 1) % APP_UART_DMA_RX_BUF_COUNT];
+    }
+    for (uint8_t i = 0; i < APP_UART_DMA_TX_BUF_COUNT; i++) {
+        lldesc_t *desc = &s_app_uart_dma_tx_desc[i];
+        desc->size = APP_UART_DMA_BUF_SIZE;
+        desc->buf = s_app_uart_dma_tx_buf[i];
+        desc->qe.stqe_next = NULL;
+    }
+
+    periph_module_enable(PERIPH_UHCI0_MODULE);
+    periph_module_reset(PERIPH_UHCI0_MODULE);
+
+    UHCI0.conf0.val = 0;
+    UHCI0.conf0.clk_en = 1;
+    UHCI0.conf0.in_rst = 1;
+    UHCI0.conf0.in_rst = 0;
+    UHCI0.conf0.out_rst = 1;
+    UHCI0.conf0.out_rst = 0;
+    UHCI0.conf0.uart0_ce = (uart_num == 0) ? 1 : 0;
+    UHCI0.conf0.uart1_ce = (uart_num == 1) ? 1 : 0;
+    // raw bytes, no SLIP separators, headers or CRC
+    UHCI0.conf0.seper_en = 0;
+    UHCI0.conf0.head_en = 0;
+    UHCI0.conf0.crc_rec_en = 0;
+    UHCI0.conf0.uart_idle_eof_en = 1;
+    UHCI0.conf0.indscr_burst_en = 1;
+    UHCI0.conf0.outdscr_burst_en = 1;
+    UHCI0.conf1.val = 0;
+    UHCI0.conf1.check_owner = 1;
+
+    uart_dev_t *uart = (uart_num == 0) ? &UART0 : &UART1;
+    uart->idle_conf.rx_idle_thrhd = APP_UART_DMA_RX_IDLE_BITS;
+
+    UHCI0.int_clr.val = 0xFFFFFFFF;
+    UHCI0.int_ena.val = APP_UART_DMA_RX_INTR | APP_UART_DMA_RX_STALL_INTR | APP_UART_DMA_TX_INTR;
+    if (esp_intr_alloc(ETS_UHCI0_INTR_SOURCE, ESP_INTR_FLAG_IRAM, app_uart_dma_isr, NULL, &s_app_uart_dma_intr) != ESP_OK) {
+        ESP_LOGE(TAG, "Interrupt allocation fail");
+        return ESP_FAIL;
+    }
+
+    app_uart_dma_rx_start(0);
+    return ESP_OK;
+}
+
+/**
+ * @brief waits for next receive buffer filled by DMA, app_uart_dma_rx_release() hands it back
+ * @param data receive buffer
+ * @param wait ticks to wait
+ * 
+ * @return length of receive buffer, 0 on timeout
+ */
+size_t app_uart_dma_rx_get(uint8_t **data, TickType_t wait)
+{
+    uint8_t index;
+    if (xQueueReceive(s_app_uart_dma_rx_queue, &index, wait) != pdTRUE) {
+        return 0;
+    }
+    s_app_uart_dma_rx_held = index;
+    *data = s_app_uart_dma_rx_buf[index];
+    return s_app_uart_dma_rx_desc[index].length;
+}
+
+/**
+ * @brief hands receive buffer of app_uart_dma_rx_get() back to DMA
+ * 
+ */
+void app_uart_dma_rx_release(void)
+{
+    if (s_app_uart_dma_rx_held >= APP_UART_DMA_RX_BUF_COUNT) {
+        return;
+    }
+    lldesc_t *desc = &s_app_uart_dma_rx_desc[s_app_uart_dma_rx_held];
+    s_app_uart_dma_rx_held = APP_UART_DMA_RX_BUF_COUNT;
+
+    portENTER_CRITICAL(&s_app_uart_dma_lock);
+    desc->length = 0;
+    desc->eof = 0;
+    desc->owner = 1;
+    s_app_uart_dma_rx_pending--;
+    if (s_app_uart_dma_rx_stalled) {
+        // DMA stopped at the oldest held descriptor, which is the one just handed back
+        s_app_uart_dma_rx_stalled = false;
+        app_uart_dma_rx_start(s_app_uart_dma_rx_next);
+    }
+    portEXIT_CRITICAL(&s_app_uart_dma_lock);
+}
+
+/**
+ * @brief copies data into transmit buffers and queues them for DMA, blocks while all buffers are queued
+ * @param data transmit data
+ * @param len data length
+ * 
+ */
+void app_uart_dma_write(const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        size_t chunk = (len > APP_UART_DMA_BUF_SIZE) ? APP_UART_DMA_BUF_SIZE : len;
+        xSemaphoreTake(s_app_uart_dma_tx_free, portMAX_DELAY);
+
+        uint8_t index = s_app_uart_dma_tx_head;
+        lldesc_t *desc = &s_app_uart_dma_tx_desc[index];
+        memcpy(s_app_uart_dma_tx_buf[index], data, chunk);
+        desc->length = chunk;
+        desc->eof = 1;
+        desc->owner = 1;
+        s_app_uart_dma_tx_head = (index + 1) % APP_UART_DMA_TX_BUF_COUNT;
+
+        portENTER_CRITICAL(&s_app_uart_dma_lock);
+        // ISR starts the next queued buffer when the one being sent completes
+        if (s_app_uart_dma_tx_queued++ == 0) {
+            app_uart_dma_tx_start(index);
+        }
+        portEXIT_CRITICAL(&s_app_uart_dma_lock);
+
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * @brief waits until DMA has passed every queued transmit buffer to UART
+ * @param wait ticks to wait
+ * 
+ * @return error code
+ */
+int app_uart_dma_tx_wait(TickType_t wait)
+{
+    TickType_t start = xTaskGetTickCount();
+    while (s_app_uart_dma_tx_queued > 0) {
+        if ((xTaskGetTickCount() - start) >= wait) {
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(1);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief UART DMA statistics
+ * @param stats UART DMA statistics
+ * 
+ */
+void app_uart_dma_stats_get(app_uart_dma_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_app_uart_dma_lock);
+    *stats = s_app_uart_dma_stats;
+    portEXIT_CRITICAL(&s_app_uart_dma_lock);
+}
+
+/** @} */ // End of app_uart_dma_global_funcs group
+#endif
+
+/** @} */ // End of app_uart_dma module
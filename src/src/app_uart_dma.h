@@ -0,0 +1,132 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_uart_dma.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application UART DMA header
+ */
+
+#ifndef APP_UART_DMA_H
+#define APP_UART_DMA_H
+
+/**
+ * @defgroup app_uart_dma Application UART DMA Module
+ * @brief Module for moving UART data through UHCI DMA buffers instead of FIFO interrupts
+ * @{
+ */
+
+/**
+ * @addtogroup app_uart_dma_include
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "config.h"
+#include "commons.h"
+/** @} */ // End of app_uart_dma_include group
+
+/**
+ * @addtogroup app_uart_dma_define
+ * @{
+ */
+
+/* 1 if WiSer-UART moves serial data with UHCI DMA */
+#if (DEVICE_CONFIG_MODE == DEVICE_CONFIG_MODE_UART) && CONFIG_UART_DMA_ENABLE
+#define APP_UART_DMA_ENABLE     1
+#else
+#define APP_UART_DMA_ENABLE     0
+#endif
+
+/** @} */ // End of app_uart_dma_define group
+
+#if APP_UART_DMA_ENABLE
+/**
+ * @addtogroup app_uart_dma_types
+ * @{
+ */
+typedef struct {
+    uint32_t rx_bytes;          /**< bytes received by DMA */
+    uint32_t rx_buffers;        /**< receive buffers completed by DMA, on idle line or when full */
+    uint32_t rx_stalls;         /**< times DMA stopped with every receive buffer waiting to be read */
+    uint32_t tx_bytes;          /**< bytes sent by DMA */
+    uint32_t tx_buffers;        /**< transmit buffers sent by DMA */
+} app_uart_dma_stats_t;
+
+/** @} */ // End of app_uart_dma_types group
+
+/**
+ * @addtogroup app_uart_dma_global_funcs
+ * @{
+ */
+
+/**
+ * @brief attaches UHCI DMA to UART, after UART driver is installed and its receive interrupts are disabled
+ * @param uart_num UART number
+ * 
+ * @return error code
+ */
+int app_uart_dma_init(int uart_num);
+/**
+ * @brief waits for next receive buffer filled by DMA, app_uart_dma_rx_release() hands it back
+ * @param data receive buffer
+ * @param wait ticks to wait
+ * 
+ * @return length of receive buffer, 0 on timeout
+ */
+size_t app_uart_dma_rx_get(uint8_t **data, TickType_t wait);
+/**
+ * @brief hands receive buffer of app_uart_dma_rx_get() back to DMA
+ * 
+ */
+void app_uart_dma_rx_release(void);
+/**
+ * @brief copies data into transmit buffers and queues them for DMA, blocks while all buffers are queued
+ * @param data transmit data
+ * @param len data length
+ * 
+ */
+void app_uart_dma_write(const uint8_t *data, size_t len);
+/**
+ * @brief waits until DMA has passed every queued transmit buffer to UART
+ * @param wait ticks to wait
+ * 
+ * @return error code
+ */
+int app_uart_dma_tx_wait(TickType_t wait);
+/**
+ * @brief UART DMA statistics
+ * @param stats UART DMA statistics
+ * 
+ */
+void app_uart_dma_stats_get(app_uart_dma_stats_t *stats);
+
+/** @} */ // End of app_uart_dma_global_funcs group
+#endif
+
+/** @} */ // End of app_uart_dma group
+
+#endif  // End of APP_UART_DMA_H
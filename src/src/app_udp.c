@@ -0,0 +1,447 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_udp.c
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application udp transport module which carries link frames to peer device over UDP
+ *
+ * WiSer-UART runs a SoftAP and WiSer-USB joins it as a station. Unlike ESPNOW the WiFi
+ * association allows A-MPDU aggregation and rate adaptation, which gives higher throughput
+ * at the cost of a connection setup.
+ */
+
+/**
+ * @defgroup app_udp Application udp transport Module
+ * @brief Module for carrying link frames to peer over UDP on a WiFi SoftAP
+ * @{
+ */
+
+/**
+ * @addtogroup app_udp_include
+ * @{
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include "config.h"
+#include "commons.h"
+#include "app_tusb.h"
+#include "app_uart.h"
+#include "app_link.h"
+#include "app_udp.h"
+
+/** @} */ // End of app_udp_include group
+
+/**
+ * @addtogroup app_udp_define
+ * @{
+ */
+
+#define APP_UDP_AP_PASSWORD     "REPLACE_WITH_AP_PASSWORD"
+
+/** @} */ // End of app_udp_define group
+
+/**
+ * @addtogroup app_udp_static_vars
+ * @{
+ */
+
+/**
+ * @brief Tag used for logging in this module
+ */
+static const char *TAG = "app_udp";
+
+static int s_app_udp_sock = -1;
+
+/* WiSer-USB sends to SoftAP gateway, WiSer-UART replies to address of first datagram received */
+static struct sockaddr_in s_app_udp_peer_addr;
+static volatile bool s_app_udp_peer_valid = false;
+
+/** @} */ // End of app_udp_static_vars group
+
+/**
+ * @addtogroup app_udp_static_funcs
+ * @{
+ */
+
+/**
+ * @brief initialize wifi as SoftAP on WiSer-UART or as station on WiSer-USB
+ *
+ */
+static void app_udp_wifi_init(void);
+
+/**
+ * @brief builds SoftAP ssid from station mac address of WiSer-UART
+ *
+ * @param ssid ssid buffer
+ * @param size size of ssid buffer
+ * @param mac station mac address of WiSer-UART
+ */
+static void app_udp_ssid_get(char *ssid, size_t size, const uint8_t *mac);
+
+/**
+ * @brief handles wifi and ip events
+ *
+ * @param arg event handler argument
+ * @param event_base event base
+ * @param event_id event id
+ * @param event_data event data
+ */
+static void app_udp_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data);
+
+/**
+ * @brief task which receives datagrams from peer and passes them to link protocol
+ *
+ * @param pvParameter task parameters
+ */
+static void app_udp_rx_task(void *pvParameter);
+
+/**
+ * @brief initialize wifi and udp socket
+ *
+ * @return  esp error code
+ */
+static esp_err_t app_udp_init(void);
+
+/**
+ * @brief sends one link frame to peer over udp
+ *
+ * @param peer_mac peer mac address, unused as peer is addressed by ip
+ * @param data frame bytes
+ * @param len length of frame
+ * @return  esp error code
+ */
+static esp_err_t app_udp_send(const uint8_t *peer_mac, const uint8_t *data, size_t len);
+
+/**
+ * @brief largest frame that fits a single datagram without ip fragmentation
+ *
+ * @return frame size in bytes
+ */
+static size_t app_udp_frame_len_max_get(void);
+
+/**
+ * @brief Wi-Fi TSF, synchronized to SoftAP beacons on WiSer-USB
+ *
+ * @return TSF in microseconds, 0 while peer is not associated
+ */
+static int64_t app_udp_tsf_get(void);
+
+/**
+ * @brief sets transmit power
+ *
+ * @param power transmit power in units of 0.25 dBm
+ */
+static void app_udp_tx_power_set(int8_t power);
+
+/**
+ * @brief transmit power
+ *
+ * @return transmit power in units of 0.25 dBm
+ */
+static int8_t app_udp_tx_power_get(void);
+
+/** @} */ // End of app_udp_static_funcs group
+
+/**
+ * @addtogroup app_udp_global_vars
+ * @{
+ */
+
+const app_link_transport_t app_udp_transport = {
+    .name = "udp",
+    .init = app_udp_init,
+    .send = app_udp_send,
+    .frame_len_max_get = app_udp_frame_len_max_get,
+    .tsf_get = app_udp_tsf_get,
+    .tx_power_set = app_udp_tx_power_set,
+    .tx_power_get = app_udp_tx_power_get,
+};
+
+/** @} */ // End of app_udp_global_vars group
+
+/**
+ * @addtogroup app_udp_static_funcs
+ * @{
+ */
+
+/**
+ * @brief builds SoftAP ssid from station mac address of WiSer-UART
+ *
+ * @param ssid ssid buffer
+ * @param size size of ssid buffer
+ * @param mac station mac address of WiSer-UART
+ */
+static void app_udp_ssid_get(char *ssid, size_t size, const uint8_t *mac)
+{
+    snprintf(ssid, size, APP_UDP_SSID_PREFIX "%02X%02X%02X", mac[3], mac[4], mac[5]);
+}
+
+/**
+ * @brief initialize wifi as SoftAP on WiSer-UART or as station on WiSer-USB
+ *
+ */
+static void app_udp_wifi_init(void)
+{
+    wifi_config_t wifi_config;
+    uint8_t mac[6];
+
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+
+    esp_wifi_stop();
+
+    // keep A-MPDU aggregation enabled, it is the main gain over ESPNOW
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK( esp_wifi_init(&cfg) );
+    ESP_ERROR_CHECK( esp_wifi_set_storage(WIFI_STORAGE_RAM) );
+
+    ESP_ERROR_CHECK( esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, app_udp_event_handler, NULL) );
+    ESP_ERROR_CHECK( esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, app_udp_event_handler, NULL) );
+
+    memset(&wifi_config, 0, sizeof(wifi_config));
+#if DEVICE_WISER_UART
+    esp_netif_create_default_wifi_ap();
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    app_udp_ssid_get((char *)wifi_config.ap.ssid, sizeof(wifi_config.ap.ssid), mac);
+    wifi_config.ap.ssid_len = strlen((char *)wifi_config.ap.ssid);
+    strncpy((char *)wifi_config.ap.password, APP_UDP_AP_PASSWORD, sizeof(wifi_config.ap.password) - 1);
+    wifi_config.ap.channel = app_link_channel_get();
+    wifi_config.ap.max_connection = 1;
+    wifi_config.ap.authmode = WIFI_AUTH_WPA2_PSK;
+    ESP_ERROR_CHECK( esp_wifi_set_mode(WIFI_MODE_AP) );
+    ESP_ERROR_CHECK( esp_wifi_set_config(WIFI_IF_AP, &wifi_config) );
+    ESP_LOGE(TAG, "SoftAP ssid: %s", (char *)wifi_config.ap.ssid);
+#elif DEVICE_WISER_USB
+    esp_netif_create_default_wifi_sta();
+    memcpy(mac, app_link_peer_mac_get(APP_LINK_SESSION_DEFAULT), sizeof(mac));
+    app_udp_ssid_get((char *)wifi_config.sta.ssid, sizeof(wifi_config.sta.ssid), mac);
+    strncpy((char *)wifi_config.sta.password, APP_UDP_AP_PASSWORD, sizeof(wifi_config.sta.password) - 1);
+    wifi_config.sta.channel = app_link_channel_get();
+    wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+    ESP_ERROR_CHECK( esp_wifi_set_mode(WIFI_MODE_STA) );
+    ESP_ERROR_CHECK( esp_wifi_set_config(WIFI_IF_STA, &wifi_config) );
+    ESP_LOGE(TAG, "joining ssid: %s", (char *)wifi_config.sta.ssid);
+#endif
+
+    //disable power saving
+    esp_wifi_set_ps (WIFI_PS_NONE);
+
+    ESP_ERROR_CHECK( esp_wifi_start());
+
+    int8_t tx_power=0;
+    esp_wifi_get_max_tx_power(&tx_power);
+    ESP_LOGE(TAG, "tx_power: %d", tx_power);
+}
+
+/**
+ * @brief handles wifi and ip events
+ *
+ * @param arg event handler argument
+ * @param event_base event base
+ * @param event_id event id
+ * @param event_data event data
+ */
+static void app_udp_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    if (event_base == WIFI_EVENT) {
+        switch (event_id) {
+            case WIFI_EVENT_STA_START:
+                esp_wifi_connect();
+                break;
+            case WIFI_EVENT_STA_DISCONNECTED:
+                ESP_LOGE(TAG, "disconnected from SoftAP, reconnecting");
+                s_app_udp_peer_valid = false;
+                esp_wifi_connect();
+                break;
+            case WIFI_EVENT_AP_STACONNECTED:
+                ESP_LOGE(TAG, "station connected");
+                break;
+            case WIFI_EVENT_AP_STADISCONNECTED:
+                ESP_LOGE(TAG, "station disconnected");
+                s_app_udp_peer_valid = false;
+                break;
+            default:
+                break;
+        }
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
+
+        memset(&s_app_udp_peer_addr, 0, sizeof(s_app_udp_peer_addr));
+        s_app_udp_peer_addr.sin_family = AF_INET;
+        s_app_udp_peer_addr.sin_port = htons(APP_UDP_PORT);
+        s_app_udp_peer_addr.sin_addr.s_addr = event->ip_info.gw.addr;
+        s_app_udp_peer_valid = true;
+        ESP_LOGE(TAG, "got ip " IPSTR ", peer " IPSTR, IP2STR(&event->ip_info.ip), IP2STR(&event->ip_info.gw));
+        app_link_transport_up();
+    }
+}
+
+/**
+ * @brief task which receives datagrams from peer and passes them to link protocol
+ *
+ * @param pvParameter task parameters
+ */
+static void IRAM_ATTR app_udp_rx_task(void *pvParameter)
+{
+    static uint8_t frame[APP_LINK_FRAME_LEN_MAX];
+    struct sockaddr_in src_addr;
+    socklen_t src_addr_len;
+    int len;
+
+    while (1) {
+        src_addr_len = sizeof(src_addr);
+        len = recvfrom(s_app_udp_sock, frame, sizeof(frame), 0, (struct sockaddr *)&src_addr, &src_addr_len);
+        if (len < 0) {
+            ESP_LOGE(TAG, "recvfrom failed: errno %d", errno);
+            vTaskDelay(10);
+            continue;
+        }
+
+#if DEVICE_WISER_UART
+        // only one station can join, reply to whoever sent the last datagram
+        if (!s_app_udp_peer_valid || src_addr.sin_addr.s_addr != s_app_udp_peer_addr.sin_addr.s_addr
+            || src_addr.sin_port != s_app_udp_peer_addr.sin_port) {
+            memcpy(&s_app_udp_peer_addr, &src_addr, sizeof(s_app_udp_peer_addr));
+            s_app_udp_peer_valid = true;
+            ESP_LOGE(TAG, "peer " IPSTR, IP2STR((esp_ip4_addr_t *)&src_addr.sin_addr.s_addr));
+            app_link_transport_up();
+        }
+#endif
+        // sockets do not carry per frame RSSI, power control then relies on frame loss
+        app_link_recv(app_link_peer_mac_get(APP_LINK_SESSION_DEFAULT), frame, len, 0);
+    }
+}
+
+/**
+ * @brief initialize wifi and udp socket
+ *
+ * @return  esp error code
+ */
+static esp_err_t app_udp_init(void)
+{
+    struct sockaddr_in local_addr;
+
+    app_udp_wifi_init();
+
+    s_app_udp_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (s_app_udp_sock < 0) {
+        ESP_LOGE(TAG, "Unable to create socket: errno %d", errno);
+        return ESP_FAIL;
+    }
+
+    memset(&local_addr, 0, sizeof(local_addr));
+    local_addr.sin_family = AF_INET;
+    local_addr.sin_port = htons(APP_UDP_PORT);
+    local_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(s_app_udp_sock, (struct sockaddr *)&local_addr, sizeof(local_addr)) < 0) {
+        ESP_LOGE(TAG, "Socket unable to bind: errno %d", errno);
+        close(s_app_udp_sock);
+        s_app_udp_sock = -1;
+        return ESP_FAIL;
+    }
+
+    xTaskCreate(app_udp_rx_task, "app_udp_rx_task", 3072, NULL, 4, NULL);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief sends one link frame to peer over udp
+ *
+ * @param peer_mac peer mac address, unused as peer is addressed by ip
+ * @param data frame bytes
+ * @param len length of frame
+ * @return  esp error code
+ */
+static esp_err_t IRAM_ATTR app_udp_send(const uint8_t *peer_mac, const uint8_t *data, size_t len)
+{
+    if (!s_app_udp_peer_valid || s_app_udp_sock < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (sendto(s_app_udp_sock, data, len, 0, (struct sockaddr *)&s_app_udp_peer_addr, sizeof(s_app_udp_peer_addr)) < 0) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief largest frame that fits a single datagram without ip fragmentation
+ *
+ * @return frame size in bytes
+ */
+static size_t app_udp_frame_len_max_get(void)
+{
+    return APP_LINK_FRAME_LEN_MAX;
+}
+
+/**
+ * @brief Wi-Fi TSF, synchronized to SoftAP beacons on WiSer-USB
+ *
+ * @return TSF in microseconds, 0 while peer is not associated
+ */
+static int64_t app_udp_tsf_get(void)
+{
+    if (!s_app_udp_peer_valid) {
+        return 0;
+    }
+#if DEVICE_WISER_UART
+    return esp_wifi_get_tsf_time(WIFI_IF_AP);
+#else
+    return esp_wifi_get_tsf_time(WIFI_IF_STA);
+#endif
+}
+
+/**
+ * @brief sets transmit power
+ *
+ * @param power transmit power in units of 0.25 dBm
+ */
+static void app_udp_tx_power_set(int8_t power)
+{
+    esp_wifi_set_max_tx_power(power);
+}
+
+/**
+ * @brief transmit power
+ *
+ * @return transmit power in units of 0.25 dBm
+ */
+static int8_t app_udp_tx_power_get(void)
+{
+    int8_t tx_power = 0;
+    esp_wifi_get_max_tx_power(&tx_power);
+    return tx_power;
+}
+
+/** @} */ // End of app_udp_static_funcs group
+
+/** @} */ // End of app_udp group
+
+/** @} */ // End of app_udp module
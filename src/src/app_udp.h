@@ -0,0 +1,75 @@
+/**********************************************************************************
+ * MIT License                                                                    *
+ *                                                                                *
+ * Copyright (c) 2024 Bitmerse LLP                                                *
+ *                                                                                *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy   *
+ * of this software and associated documentation files (the "Software"), to deal  *
+ * in the Software without restriction, including without limitation the rights   *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      *
+ * copies of the Software, and to permit persons to whom the Software is          *
+ * furnished to do so, subject to the following conditions:                       *
+ *                                                                                *
+ * The above copyright notice and this permission notice shall be included in all *
+ * copies or substantial portions of the Software.                                *
+ *                                                                                *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  *
+ * SOFTWARE.                                                                      *
+ *********************************************************************************/
+/**
+ * @file app_udp.h
+ * @author Dhrumil Doshi
+ * @date 19 October 2026
+ * @brief Application udp transport header
+ */
+
+#ifndef APP_UDP_H
+#define APP_UDP_H
+
+/**
+ * @defgroup app_udp Application udp transport Module
+ * @brief Module for carrying link frames to peer over UDP on a WiFi SoftAP
+ * @{
+ */
+
+/**
+ * @addtogroup app_udp_include
+ * @{
+ */
+
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "app_link.h"
+/** @} */ // End of app_udp_include group
+
+/**
+ * @addtogroup app_udp_define
+ * @{
+ */
+
+/* UDP port used by both peers */
+#define APP_UDP_PORT            3333
+
+/* SoftAP ssid is prefix followed by last three bytes of WiSer-UART station mac address */
+#define APP_UDP_SSID_PREFIX     "WiSer-"
+
+/** @} */ // End of app_udp_define group
+
+/**
+ * @addtogroup app_udp_global_vars
+ * @{
+ */
+extern const app_link_transport_t app_udp_transport;
+/** @} */ // End of app_udp_global_vars group
+
+/** @} */ // End of app_udp group
+
+#endif
@@ -58,6 +58,16 @@
 #define HW_FLOW_DIS_CONN_OFF_PERIOD  500   /**< Connection indication period in milliseconds */
 #define HW_FLOW_DIS_APP_CONN_ON_COUNT  5   /**< Connection indication flash count */
 
+/* serial state bits, same positions as in CDC SERIAL_STATE notification */
+#define SERIAL_STATE_DCD        (1 << 0)    /**< carrier detect, peer is heard */
+#define SERIAL_STATE_DSR        (1 << 1)    /**< data set ready, peer is heard */
+#define SERIAL_STATE_BREAK      (1 << 2)    /**< break received by target side UART */
+#define SERIAL_STATE_RING       (1 << 3)    /**< ring indicator, not wired */
+#define SERIAL_STATE_FRAMING    (1 << 4)    /**< framing error */
+#define SERIAL_STATE_PARITY     (1 << 5)    /**< parity error */
+#define SERIAL_STATE_OVERRUN    (1 << 6)    /**< received bytes lost to UART FIFO overflow */
+#define SERIAL_STATE_ERRORS     (SERIAL_STATE_BREAK | SERIAL_STATE_FRAMING | SERIAL_STATE_PARITY | SERIAL_STATE_OVERRUN)
+
 /** @} */ // End of commons_define group
 
 /**
@@ -76,6 +86,9 @@ typedef struct {
     uint8_t parity;
     uint8_t stop_bits;
     uint8_t hw_flow_status;
+    uint32_t stream_isn;    /**< initial offset of sender data stream, set by app_link */
+    uint32_t stream_offset; /**< sender data stream offset the settings apply from, set by app_link */
+    uint8_t sw_flow_status; /**< 1 for XON/XOFF between WiSer-UART and its target, appended so older peers read 0 */
 } config_settings_t;
 
 typedef struct {
@@ -84,10 +97,55 @@ typedef struct {
     int conn_on_count;
 } device_conn_t;
 
+typedef struct {
+    uint8_t reply_req;          /**< 1 if peer should answer with its own capabilities */
+    uint8_t hops;               /**< relays behind the sender, 0 for an end device, fills padding so older peers read 0 */
+    uint16_t max_data_size;     /**< largest data payload the device can send and receive */
+} link_caps_t;
+
 typedef struct {
     uint8_t type;
     uint8_t ser_count;
+    uint32_t offset;    /**< next expected stream byte offset, data acks only */
 } data_ack_t;
+
+typedef struct {
+    uint8_t reply;          /**< 0 for request, 1 for response */
+    uint8_t seq;            /**< request sequence number, echoed in response */
+    int64_t t1;             /**< request transmit time on requester clock in microseconds */
+    int64_t t2;             /**< request receive time on responder clock */
+    int64_t t3;             /**< response transmit time on responder clock */
+    int64_t tsf_base;       /**< sender esp_timer minus Wi-Fi TSF, 0 if TSF is not shared */
+} time_sync_t;
+
+typedef struct {
+    uint8_t enable;         /**< 1 to restrict data frames to slot, 0 to send freely */
+    uint8_t slot;           /**< slot index within frame period */
+    uint32_t frame_period;  /**< frame period in microseconds, frames start at multiples on coordinator clock */
+    uint32_t slot_len;      /**< slot length in microseconds */
+} tdma_assign_t;
+
+typedef struct {
+    int8_t rssi;            /**< average RSSI of frames received from peer in dBm, 0 if unknown */
+    uint8_t loss;           /**< sender data frame loss in percent */
+    int8_t tx_power;        /**< sender transmit power in units of 0.25 dBm */
+} link_report_t;
+
+typedef struct {
+    uint8_t xoff;           /**< 1 once target sent XOFF, 0 once it sent XON */
+    int64_t time;           /**< time target sent it on sender clock in microseconds, 0 if not comparable with peer clock */
+} flow_ctrl_t;
+
+typedef struct {
+    uint16_t errors;        /**< SERIAL_STATE_ERRORS bits seen since last report, 0 for a periodic report */
+    uint8_t cts;            /**< 1 while target asserts CTS */
+} serial_state_t;
+
+typedef struct {
+    uint32_t bitrate;       /**< bitrate locked to, the standard bitrate nearest to measured one */
+    uint32_t measured;      /**< bitrate measured from bit timing of target */
+    uint8_t override;       /**< 1 if locked bitrate is kept over bitrate set by host */
+} autobaud_t;
 /** @} */ // End of commons_types group
 
 /**
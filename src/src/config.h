@@ -51,9 +51,11 @@
 #define DEVICE_CONFIG_MODE_NONE 0
 #define DEVICE_CONFIG_MODE_USB  1
 #define DEVICE_CONFIG_MODE_UART 2
+#define DEVICE_CONFIG_MODE_RELAY 3
+#define DEVICE_CONFIG_MODE_SNIFFER 4
 
 
-/* select device mode to either DEVICE_CONFIG_MODE_USB or DEVICE_CONFIG_MODE_UART */
+/* select device mode to either DEVICE_CONFIG_MODE_USB, DEVICE_CONFIG_MODE_UART, DEVICE_CONFIG_MODE_RELAY (forwards between peer_mac and relay_peer_mac from NVS) or DEVICE_CONFIG_MODE_SNIFFER (WiSer-USB reporting frames between sniff_mac_0 and sniff_mac_1 from NVS) */
 #define DEVICE_CONFIG_MODE  DEVICE_CONFIG_MODE_NONE
 
 /* assign 1 to Broadcast messages to all devices and 0 for continue communication between only paired device */
@@ -65,6 +67,126 @@
 /* assign 1 to use prepaired devices in produciton (CONFIG_ESPNOW_BROADCAST_ENABLE must be disabled to use prepaired devices)*/
 #define CONFIG_ESPNOW_USE_NVS_PEER_MAC     1
 
+/* assign 1 to negotiate ESP-NOW v2 payloads (up to 1470 bytes) with peer, requires ESP-IDF v5.4 or later on both devices */
+#define CONFIG_ESPNOW_V2_PAYLOAD_ENABLE    1
+
+#define LINK_TRANSPORT_ESPNOW   0
+#define LINK_TRANSPORT_UDP      1
+
+/* default operating channel (range 1 13) */
+#define CONFIG_LINK_CHANNEL     5
+
+/* assign 1 to derive operating channel of each pair from both MAC addresses over CONFIG_LINK_CHANNEL_LIST, spreading pairs across the band (a channel stored in NVS overrides it) */
+#define CONFIG_LINK_CHANNEL_AUTO_ENABLE    0
+#define CONFIG_LINK_CHANNEL_LIST    { 1, 5, 9, 13 }
+
+/* number of WiSer-UART peers served by one WiSer-USB (range 1 4), each on its own CDC port with MAC address from NVS peer table, peers beyond CONFIG_TINYUSB_CDC_COUNT need CONFIG_USB_MUX_ENABLE */
+#define CONFIG_LINK_PEER_COUNT  1
+
+/* assign 1 to let WiSer-UART fail over to a standby WiSer-USB stored under "standby_peer_mac" in NVS, replaying unacknowledged data to it */
+#define CONFIG_LINK_FAILOVER_ENABLE     0
+/* silence of the active WiSer-USB in milliseconds, while data waits for acknowledgement, before WiSer-UART switches to the standby */
+#define CONFIG_LINK_FAILOVER_MS         300
+
+/* 1 to carry peers without a CDC port over the USB vendor-class interface (needs CONFIG_TINYUSB_VENDOR_ENABLED), 0 to disable */
+#define CONFIG_USB_MUX_ENABLE   0
+
+/* link frame payload bytes reported in hex by sniffer per frame, 0 for metadata only */
+#define CONFIG_SNIFFER_PAYLOAD_LEN      0
+/* interval of sniffer frame and retry counters in milliseconds */
+#define CONFIG_SNIFFER_STATS_PERIOD_MS  1000
+
+/* select link transport to either LINK_TRANSPORT_ESPNOW (connectionless) or LINK_TRANSPORT_UDP (WiSer-UART runs a SoftAP, WiSer-USB joins it) */
+#define CONFIG_LINK_TRANSPORT   LINK_TRANSPORT_ESPNOW
+
+/* bounds of data frame payload in bytes, frames shrink towards min on frame loss and grow back towards max (capped by negotiated mtu) */
+#define CONFIG_LINK_CHUNK_SIZE_MIN  32
+#define CONFIG_LINK_CHUNK_SIZE_MAX  1464
+
+/* airtime weights of host to target data (WiSer-USB to WiSer-UART), target to host data, control frames and acknowledgements, must be same on both devices */
+#define CONFIG_LINK_SCHED_WEIGHT_H2T    1
+#define CONFIG_LINK_SCHED_WEIGHT_T2H    1
+#define CONFIG_LINK_SCHED_WEIGHT_CTRL   4
+#define CONFIG_LINK_SCHED_WEIGHT_ACK    8
+
+/* interval of clock synchronization exchanges with peer in milliseconds */
+#define CONFIG_TSYNC_PERIOD_MS      1000
+
+/* assign 1 to derive clock offset from Wi-Fi TSF when transport shares it between devices (LINK_TRANSPORT_UDP) */
+#define CONFIG_TSYNC_TSF_ENABLE     1
+
+/* assign 1 to let WiSer-USB assign TDMA time slots and restrict data frames of both devices to their slot */
+#define CONFIG_TDMA_ENABLE              0
+/* TDMA frame period in microseconds, bounds how long a device waits for its turn */
+#define CONFIG_TDMA_FRAME_PERIOD_US     20000
+/* number of nodes served by the coordinator, each gets one slot besides the coordinator slot */
+#define CONFIG_TDMA_NODE_COUNT          1
+/* time left in slot needed to start a data frame, covers frame and acknowledgement airtime */
+#define CONFIG_TDMA_GUARD_US            2000
+/* interval of slot assignment announcements by coordinator in milliseconds */
+#define CONFIG_TDMA_ASSIGN_PERIOD_MS    5000
+
+/* assign 1 to lower transmit power while peer receives with margin, 0 to always transmit at maximum power */
+#define CONFIG_TXPWR_CONTROL_ENABLE     1
+/* interval of link reports and transmit power adjustment in milliseconds */
+#define CONFIG_TXPWR_PERIOD_MS          500
+/* RSSI in dBm the peer should receive at, and margin above it in dB before power is lowered */
+#define CONFIG_TXPWR_RSSI_TARGET        (-67)
+#define CONFIG_TXPWR_RSSI_HYSTERESIS    6
+/* data frame loss in percent above which power is raised regardless of RSSI */
+#define CONFIG_TXPWR_LOSS_HIGH          5
+/* lowest transmit power in units of 0.25 dBm (range 8 84) */
+#define CONFIG_TXPWR_MIN                8
+
+/* assign 1 to encrypt link frames with AES-GCM above the transport instead of ESP-NOW LMK, with a group key shared by any number of devices, must be same on both devices */
+#define CONFIG_LINK_AEAD_ENABLE         0
+
+/* size of WiSer-UART receive ring between UART driver and link in bytes, must be power of 2, absorbs serial data while radio waits for acknowledgements */
+#define CONFIG_UART_RX_RING_SIZE        16384
+
+/* size of WiSer-UART transmit ring between link and UART in bytes, must be power of 2 and at least 16384, absorbs data of peer while target holds off */
+#define CONFIG_UART_TX_RING_SIZE        16384
+
+/* WiSer-UART receive profile setting idle timeout, FIFO threshold and read size from bitrate, 0 for latency, 1 for balanced and 2 for throughput */
+#define CONFIG_UART_RX_PROFILE          1
+
+/* WiSer-UART holds the sender off before its receive ring fills, 0 to disable, 1 by RTS while hardware flow control is on, 2 by RTS or else by sending XOFF/XON */
+#define CONFIG_UART_RX_BACKPRESSURE     1
+
+/* receive ring occupancy in percent at which the sender is held off, and released again */
+#define CONFIG_UART_RX_HIGH_WATERMARK   75
+#define CONFIG_UART_RX_LOW_WATERMARK    25
+
+/* interval of statistics log in milliseconds, WiSer-UART receive ring, receive latency and DMA, WiSer-USB XON/XOFF and serial state of each port, 0 to disable */
+#define CONFIG_STATS_LOG_PERIOD_MS      10000
+
+/* assign 1 to use XON/XOFF flow control between WiSer-UART and its target, set on WiSer-USB and sent with line settings */
+#define CONFIG_UART_SW_FLOW_ENABLE      0
+
+/* highest bitrate in bits per second WiSer-UART is set to (up to 5000000), UART driver buffers and transmit FIFO threshold are sized for it, above 921600 use with CONFIG_UART_DMA_ENABLE and hardware flow control */
+#define CONFIG_UART_BITRATE_MAX         921600
+
+/* byte ending a line or packet from WiSer-UART target, received bytes go to link on it instead of after idle timeout, -1 to disable, e.g. '\n' for text, 0x7E for HDLC, 0x00 for COBS, not used with CONFIG_UART_DMA_ENABLE */
+#define CONFIG_UART_RX_DELIMITER        -1
+
+/* assign 1 to move WiSer-UART serial data with UHCI DMA instead of UART FIFO interrupts, for bitrates of 921600 and above up to 5000000 */
+#define CONFIG_UART_DMA_ENABLE          0
+
+/* size of each UART DMA buffer in bytes, multiple of 4 up to 4092 */
+#define CONFIG_UART_DMA_BUF_SIZE        4092
+
+/* count of UART DMA receive buffers, at least 2 so DMA fills one while another is read */
+#define CONFIG_UART_DMA_RX_BUF_COUNT    4
+
+/* WiSer-UART detects bitrate of its target from bit timing on RX, 0 to disable, 1 to detect and report to WiSer-USB until host sets bitrate, 2 to keep detected bitrate over bitrate set by host */
+#define CONFIG_UART_AUTOBAUD            0
+
+/* assign 1 to report WiSer-UART break, parity, framing and overrun errors and link loss to the host as CDC serial state, must be same on both devices */
+#define CONFIG_SERIAL_STATE_ENABLE      1
+
+/* interval of serial state repeated by WiSer-UART in milliseconds, WiSer-USB drops carrier detect after 3 intervals without it */
+#define CONFIG_SERIAL_STATE_PERIOD_MS   1000
+
 /** @} */ // End of config_define group
 
 /**
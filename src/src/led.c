@@ -44,6 +44,8 @@
 #include "commons.h"
 #include "app_tusb.h"
 #include "app_uart.h"
+#include "app_relay.h"
+#include "app_sniffer.h"
 #include "led.h"
 
 /** @} */ // End of led_include group
@@ -53,13 +55,15 @@
  * @{
  */
 
-#if DEVICE_WISER_USB
+/* sniffer runs on WiSer-USB hardware */
+#if DEVICE_WISER_USB || DEVICE_WISER_SNIFFER
 #define LED_TX_GPIO GPIO_NUM_35
 #define LED_RX_GPIO GPIO_NUM_34
 #define LED_CONN_GPIO GPIO_NUM_35
 #endif
 
-#if DEVICE_WISER_UART
+/* relay runs on WiSer-UART hardware */
+#if DEVICE_WISER_UART || DEVICE_WISER_RELAY
 #define LED_CONN_GPIO GPIO_NUM_21
 #endif
 
@@ -102,7 +106,7 @@ static bool led_conn_on_flag = false;
  */
 void led_init(void)
 {
-#if DEVICE_WISER_USB
+#if DEVICE_WISER_USB || DEVICE_WISER_SNIFFER
     gpio_set_direction(LED_TX_GPIO, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_RX_GPIO, GPIO_MODE_OUTPUT);
     led_tx_off();
@@ -120,7 +124,7 @@ void led_init(void)
  */
 void led_tx_on(void)
 {
-#if DEVICE_WISER_USB  
+#if DEVICE_WISER_USB || DEVICE_WISER_SNIFFER
     gpio_set_level(LED_TX_GPIO, LED_GPIO_ON);
 #endif
 }
@@ -131,7 +135,7 @@ void led_tx_on(void)
  */
 void led_tx_off(void)
 {
-#if DEVICE_WISER_USB
+#if DEVICE_WISER_USB || DEVICE_WISER_SNIFFER
     if(led_conn_on_flag == false) {
         gpio_set_level(LED_TX_GPIO, LED_GPIO_OFF);
     }
@@ -144,7 +148,7 @@ void led_tx_off(void)
  */
 void led_rx_on(void)
 {
-#if DEVICE_WISER_USB
+#if DEVICE_WISER_USB || DEVICE_WISER_SNIFFER
     gpio_set_level(LED_RX_GPIO, LED_GPIO_ON);
 #endif
 }
@@ -155,7 +159,7 @@ void led_rx_on(void)
  */
 void led_rx_off(void)
 {
-#if DEVICE_WISER_USB
+#if DEVICE_WISER_USB || DEVICE_WISER_SNIFFER
     gpio_set_level(LED_RX_GPIO, LED_GPIO_OFF);
 #endif
 }
@@ -193,6 +193,179 @@ void nvs_peer_write(uint8_t *mac)
     }
 }
 
+/**
+ * @brief reads MAC address of an additional peer from the NVS peer table, peer 0 is the one read by nvs_peer_read
+ *
+ * @param index peer table index, stored under key "peer_mac_<index>"
+ * @param mac pointer to peer mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_table_read(uint8_t index, uint8_t *mac)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    size_t len = NVS_PEER_MAC_ADDR_LEN;
+    char key[NVS_KEY_NAME_MAX_SIZE];
+
+    snprintf(key, sizeof(key), "peer_mac_%u", (unsigned int)index);
+    if(my_handle != NULL) {
+        err = nvs_get_blob(my_handle, key, mac, &len);
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            printf("Error (%s) reading!\n", esp_err_to_name(err));
+        }
+    }
+    return (err == ESP_OK);
+}
+
+/**
+ * @brief reads MAC address of the downstream peer of a relay from NVS memory
+ *
+ * @param mac pointer to peer mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_relay_read(uint8_t *mac)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    size_t len = NVS_PEER_MAC_ADDR_LEN;
+    if(my_handle != NULL) {
+        err = nvs_get_blob(my_handle, "relay_peer_mac", mac, &len);
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            printf("Error (%s) reading!\n", esp_err_to_name(err));
+        }
+    }
+    return (err == ESP_OK);
+}
+
+/**
+ * @brief reads MAC address of the standby WiSer-USB of a WiSer-UART from NVS memory
+ *
+ * @param mac pointer to standby mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_standby_read(uint8_t *mac)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    size_t len = NVS_PEER_MAC_ADDR_LEN;
+    if(my_handle != NULL) {
+        err = nvs_get_blob(my_handle, "standby_peer_mac", mac, &len);
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            printf("Error (%s) reading!\n", esp_err_to_name(err));
+        }
+    }
+    return (err == ESP_OK);
+}
+
+/**
+ * @brief reads MAC address of one device of the pair watched by a sniffer from NVS memory
+ *
+ * @param index device of the pair, 0 or 1, stored under key "sniff_mac_<index>"
+ * @param mac pointer to mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_sniff_read(uint8_t index, uint8_t *mac)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    size_t len = NVS_PEER_MAC_ADDR_LEN;
+    char key[NVS_KEY_NAME_MAX_SIZE];
+
+    snprintf(key, sizeof(key), "sniff_mac_%u", (unsigned int)index);
+    if(my_handle != NULL) {
+        err = nvs_get_blob(my_handle, key, mac, &len);
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            printf("Error (%s) reading!\n", esp_err_to_name(err));
+        }
+    }
+    return (err == ESP_OK);
+}
+
+/**
+ * @brief reads channel override of the pair from NVS memory
+ *
+ * @param channel pointer to channel, left unchanged if no override is stored
+ * @return true if an override is stored
+ */
+bool nvs_peer_channel_read(uint8_t *channel)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    if(my_handle != NULL) {
+        err = nvs_get_u8(my_handle, "peer_channel", channel);
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            printf("Error (%s) reading!\n", esp_err_to_name(err));
+        }
+    }
+    return (err == ESP_OK);
+}
+
+/**
+ * @brief writes channel override of the pair to NVS memory
+ *
+ * @param channel channel to use for the pair
+ */
+void nvs_peer_channel_write(uint8_t channel)
+{
+    if(my_handle != NULL) {
+        printf("Updating peer channel in NVS...");
+        esp_err_t err = nvs_set_u8(my_handle, "peer_channel", channel);
+        printf((err != ESP_OK) ? "Failed!\n" : "Done\n");
+
+        printf("Committing updates in NVS ... ");
+        err = nvs_commit(my_handle);
+        printf((err != ESP_OK) ? "Failed!\n" : "Done\n");
+    }
+}
+
+/**
+ * @brief reads link encryption key from NVS memory
+ *
+ * @param key pointer to key, left unchanged if no key is stored
+ * @param len length of key
+ * @return true if a key of that length is stored
+ */
+bool nvs_peer_key_read(uint8_t *key, size_t len)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    size_t stored_len = 0;
+    if(my_handle != NULL) {
+        err = nvs_get_blob(my_handle, "link_key", NULL, &stored_len);
+        if(err == ESP_OK && stored_len == len) {
+            err = nvs_get_blob(my_handle, "link_key", key, &stored_len);
+        } else if(err == ESP_OK) {
+            printf("Stored link key has wrong length!\n");
+            err = ESP_ERR_INVALID_SIZE;
+        }
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND && err != ESP_ERR_INVALID_SIZE) {
+            printf("Error (%s) reading!\n", esp_err_to_name(err));
+        }
+    }
+    return (err == ESP_OK);
+}
+
+/**
+ * @brief advances link encryption key epoch stored in NVS memory
+ *
+ * @param epoch pointer to new epoch
+ * @return true if the new epoch is stored
+ */
+bool nvs_peer_aead_epoch_next(uint32_t *epoch)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    uint32_t value = 0; // value will default to 0, if not set yet in NVS
+    if(my_handle != NULL) {
+        err = nvs_get_u32(my_handle, "aead_epoch", &value);
+        if(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND) {
+            value++;
+            err = nvs_set_u32(my_handle, "aead_epoch", value);
+        }
+        if(err == ESP_OK) {
+            err = nvs_commit(my_handle);
+        }
+        if(err != ESP_OK) {
+            printf("Error (%s) updating key epoch!\n", esp_err_to_name(err));
+        }
+    }
+    *epoch = value;
+    return (err == ESP_OK);
+}
+
 /** @} */ // End of nvs_peer_global_funcs group
 
 /** @} */ // End of nvs_peer module
\ No newline at end of file
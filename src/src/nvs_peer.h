@@ -42,6 +42,10 @@
  * @{
  */
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
 /** @} */ // End of nvs_peer_include group
 
 
@@ -102,6 +106,72 @@ void nvs_peer_read(uint8_t *mac);
  */
 void nvs_peer_write(uint8_t *mac);
 
+/**
+ * @brief reads MAC address of an additional peer from the NVS peer table, peer 0 is the one read by nvs_peer_read
+ *
+ * @param index peer table index, stored under key "peer_mac_<index>"
+ * @param mac pointer to peer mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_table_read(uint8_t index, uint8_t *mac);
+
+/**
+ * @brief reads MAC address of the downstream peer of a relay from NVS memory
+ *
+ * @param mac pointer to peer mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_relay_read(uint8_t *mac);
+
+/**
+ * @brief reads MAC address of the standby WiSer-USB of a WiSer-UART from NVS memory
+ *
+ * @param mac pointer to standby mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_standby_read(uint8_t *mac);
+
+/**
+ * @brief reads MAC address of one device of the pair watched by a sniffer from NVS memory
+ *
+ * @param index device of the pair, 0 or 1, stored under key "sniff_mac_<index>"
+ * @param mac pointer to mac address, left unchanged if no address is stored
+ * @return true if an address is stored
+ */
+bool nvs_peer_sniff_read(uint8_t index, uint8_t *mac);
+
+/**
+ * @brief reads channel override of the pair from NVS memory
+ *
+ * @param channel pointer to channel, left unchanged if no override is stored
+ * @return true if an override is stored
+ */
+bool nvs_peer_channel_read(uint8_t *channel);
+
+/**
+ * @brief writes channel override of the pair to NVS memory
+ *
+ * @param channel channel to use for the pair
+ */
+void nvs_peer_channel_write(uint8_t channel);
+
+/**
+ * @brief reads link encryption key from NVS memory
+ *
+ * @param key pointer to key, left unchanged if no key is stored
+ * @param len length of key
+ * @return true if a key of that length is stored
+ */
+bool nvs_peer_key_read(uint8_t *key, size_t len);
+
+/**
+ * @brief advances link encryption key epoch stored in NVS memory
+ *
+ * @param epoch pointer to new epoch
+ * @return true if the new epoch is stored
+ */
+bool nvs_peer_aead_epoch_next(uint32_t *epoch);
+
 /** @} */ // End of nvs_peer_global_funcs group
 /** @} */ // End of nvs_peer group
 #endif
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+# MIT License
+#
+# Copyright (c) 2024 Bitmerse LLP
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+"""Throughput benchmark of a WiSer pair at high bitrates.
+
+The WiSer-USB CDC port is one end. The other end is a USB-UART adapter wired to
+TX, RX, RTS and CTS of the WiSer-UART, which must reach the highest bitrate
+tested (FT232H or FT2232H for 4 Mbaud). For each bitrate both ports are set to
+it, a seeded pseudo-random stream is sent for the given time and the received
+bytes are compared with the sent ones. A run is lossless when every byte
+arrives in order.
+
+Build the WiSer-UART with CONFIG_UART_BITRATE_MAX at or above the highest
+bitrate and CONFIG_UART_DMA_ENABLE set. Above the radio throughput the sender
+is held off, so enable hardware flow control on the WiSer-USB (long press of
+the CONN button) and pass --rtscts.
+
+Needs pyserial.
+
+    python wiser_bench.py COM5 COM6 --rtscts
+    python wiser_bench.py /dev/ttyACM0 /dev/ttyUSB0 --bauds 2000000 3000000 --dir both
+"""
+
+import argparse
+import random
+import sys
+import threading
+import time
+
+import serial
+
+BAUDS = [1500000, 2000000, 3000000, 4000000]
+CHUNK = 4096
+# line coding goes over the link before the WiSer-UART switches
+SETTLE_S = 0.5
+# bytes still in flight once the sender stops
+DRAIN_S = 2.0
+
+
+class _Run:
+    """One direction of a run, sender and receiver on their own threads."""
+
+    def __init__(self, name, tx, rx, seed, seconds):
+        self.name = name
+        self.tx = tx
+        self.rx = rx
+        self.seconds = seconds
+        self.sent = bytearray()
+        self.received = bytearray()
+        self._rng = random.Random(seed)
+        self.first_rx = None
+        self.last_rx = None
+
+    def send(self):
+        end = time.monotonic() + self.seconds
+        while time.monotonic() < end:
+            data = self._rng.randbytes(CHUNK)
+            self.tx.write(data)
+            self.sent += data
+        self.tx.flush()
+
+    def receive(self, stop):
+        while not stop.is_set() or self.rx.in_waiting:
+            data = self.rx.read(self.rx.in_waiting or 1)
+            if data:
+                now = time.monotonic()
+                if self.first_rx is None:
+                    self.first_rx = now
+                self.last_rx = now
+                self.received += data
+
+    def result(self):
+        length = min(len(self.sent), len(self.received))
+        mismatch = next((i for i in range(length) if self.sent[i] != self.received[i]), None)
+        lossless = mismatch is None and len(self.received) == len(self.sent)
+        elapsed = (self.last_rx - self.first_rx) if self.first_rx is not None and self.last_rx > self.first_rx else 0
+        rate = len(self.received) / elapsed if elapsed else 0
+        return lossless, mismatch, rate
+
+
+def _open(port, baud, rtscts):
+    return serial.Serial(port, baud, timeout=0.05, write_timeout=None, rtscts=rtscts)
+
+
+def bench(usb_port, uart_port, baud, seconds, direction, rtscts):
+    usb = _open(usb_port, baud, False)
+    uart = _open(uart_port, baud, rtscts)
+    try:
+        time.sleep(SETTLE_S)
+        usb.reset_input_buffer()
+        uart.reset_input_buffer()
+
+        runs = []
+        if direction in ("up", "both"):
+            runs.append(_Run("uart->usb", uart, usb, baud, seconds))
+        if direction in ("down", "both"):
+            runs.append(_Run("usb->uart", usb, uart, baud + 1, seconds))
+
+        stop = threading.Event()
+        receivers = [threading.Thread(target=r.receive, args=(stop,)) for r in runs]
+        senders = [threading.Thread(target=r.send) for r in runs]
+        for t in receivers + senders:
+            t.start()
+        for t in senders:
+            t.join()
+        # receive until the line stays quiet
+        while True:
+            before = sum(len(r.received) for r in runs)
+            time.sleep(DRAIN_S)
+            if sum(len(r.received) for r in runs) == before:
+                break
+        stop.set()
+        for t in receivers:
+            t.join()
+        return runs
+    finally:
+        usb.close()
+        uart.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="WiSer high bitrate benchmark")
+    parser.add_argument("usb", help="CDC port of WiSer-USB")
+    parser.add_argument("uart", help="port of USB-UART adapter wired to WiSer-UART")
+    parser.add_argument("--bauds", type=int, nargs="+", default=BAUDS)
+    parser.add_argument("--seconds", type=float, default=10.0, help="send time per run")
+    parser.add_argument("--dir", choices=("up", "down", "both"), default="up",
+                        help="up: target to host, down: host to target")
+    parser.add_argument("--rtscts", action="store_true", help="hardware flow control on the adapter")
+    args = parser.parse_args()
+
+    failed = False
+    print(f"{'baud':>9} {'direction':>10} {'sent':>10} {'received':>10} {'kB/s':>8} {'line %':>7}  result")
+    for baud in args.bauds:
+        for run in bench(args.usb, args.uart, baud, args.seconds, args.dir, args.rtscts):
+            lossless, mismatch, rate = run.result()
+            failed |= not lossless
+            line = rate * 10 * 100 / baud
+            if lossless:
+                verdict = "lossless"
+            elif mismatch is not None:
+                verdict = f"mismatch at byte {mismatch}"
+            else:
+                verdict = f"{len(run.sent) - len(run.received)} bytes missing"
+            print(f"{baud:>9} {run.name:>10} {len(run.sent):>10} {len(run.received):>10} "
+                  f"{rate / 1000:>8.1f} {line:>7.1f}  {verdict}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
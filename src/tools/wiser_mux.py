@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+# MIT License
+#
+# Copyright (c) 2024 Bitmerse LLP
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+"""Host side of the WiSer-USB multiplexer (CONFIG_USB_MUX_ENABLE).
+
+Streams are link sessions of WiSer-UART peers without a CDC port. Every frame is
+[0xA5][type][stream][length LE16][payload]. Data towards a peer is only sent up to
+the credit limit the device reports for that stream, so one slow peer never stalls
+the others.
+
+Needs pyusb and, on Windows, the WinUSB driver bound to the vendor interface.
+
+    python wiser_mux.py info
+    python wiser_mux.py stats 1
+    python wiser_mux.py term 1 --baud 115200
+"""
+
+import argparse
+import struct
+import sys
+import threading
+import time
+
+import usb.core
+import usb.util
+
+VID = 0x303A
+
+SYNC = 0xA5
+HEADER = struct.Struct("<BBBH")
+PAYLOAD_MAX = 512
+STREAM_NONE = 0xFF
+
+TYPE_DATA = 0
+TYPE_CONFIG = 1
+TYPE_HW_LINE = 2
+TYPE_INFO_REQ = 3
+TYPE_INFO = 4
+TYPE_STATS_REQ = 5
+TYPE_STATS = 6
+TYPE_CREDIT = 7
+
+CONFIG = struct.Struct("<IBBBB")
+HW_LINE = struct.Struct("<BB")
+INFO = struct.Struct("<BBBBH")
+CREDIT = struct.Struct("<II")
+STATS = struct.Struct("<8IHHbbBB")
+STATS_FIELDS = ("frames_sent", "frames_retx", "frames_dropped", "bytes_acked", "loss",
+                "tx_rate", "rx_rate", "crypto_rejected", "mtu", "chunk", "rssi",
+                "tx_power", "hops")
+
+PARITY = {"N": 0, "O": 1, "E": 2, "M": 3, "S": 4}
+STOP_BITS = {1: 0, 1.5: 1, 2: 2}
+
+
+class _Stream:
+    def __init__(self):
+        self.rx = bytearray()
+        self.sent = 0           # data bytes sent, wraps at 32 bits like the device counter
+        self.limit = 0          # credit limit last reported by device
+        self.synced = False     # false until first credit after INFO
+        self.stats = None
+
+
+class WiserMux:
+    """Vendor-class interface of one WiSer-USB."""
+
+    def __init__(self, serial=None, timeout=1.0):
+        match = {"idVendor": VID}
+        if serial is not None:
+            match["serial_number"] = serial
+        self.dev = usb.core.find(**match)
+        if self.dev is None:
+            raise IOError("WiSer-USB not found")
+        cfg = self.dev.get_active_configuration()
+        self.itf = usb.util.find_descriptor(cfg, bInterfaceClass=0xFF)
+        if self.itf is None:
+            raise IOError("vendor interface not found, is CONFIG_TINYUSB_VENDOR_ENABLED set?")
+        try:
+            if self.dev.is_kernel_driver_active(self.itf.bInterfaceNumber):
+                self.dev.detach_kernel_driver(self.itf.bInterfaceNumber)
+        except (NotImplementedError, usb.core.USBError):
+            pass
+        usb.util.claim_interface(self.dev, self.itf)
+        self.ep_out = usb.util.find_descriptor(self.itf, custom_match=lambda e:
+            usb.util.endpoint_direction(e.bEndpointAddress) == usb.util.ENDPOINT_OUT)
+        self.ep_in = usb.util.find_descriptor(self.itf, custom_match=lambda e:
+            usb.util.endpoint_direction(e.bEndpointAddress) == usb.util.ENDPOINT_IN)
+
+        self.timeout = timeout
+        self.streams = {}
+        self.info_reply = None
+        self.cond = threading.Condition()
+        self.tx_lock = threading.Lock()
+        self.running = True
+        self.reader = threading.Thread(target=self._read_loop, daemon=True)
+        self.reader.start()
+        self.info()
+
+    def close(self):
+        self.running = False
+        self.reader.join()
+        usb.util.release_interface(self.dev, self.itf)
+        usb.util.dispose_resources(self.dev)
+
+    def _send(self, ftype, stream, payload=b""):
+        with self.tx_lock:
+            self.ep_out.write(HEADER.pack(SYNC, ftype, stream, len(payload)) + bytes(payload))
+
+    def _read_loop(self):
+        buf = bytearray()
+        while self.running:
+            try:
+                # device sends no zero length packets, so read max packets and reassemble
+                buf += bytes(self.ep_in.read(self.ep_in.wMaxPacketSize, timeout=100))
+            except usb.core.USBTimeoutError:
+                continue
+            except usb.core.USBError:
+                if self.running:
+                    raise
+                return
+            while True:
+                start = buf.find(bytes([SYNC]))
+                if start < 0:
+                    buf.clear()
+                    break
+                del buf[:start]
+                if len(buf) < HEADER.size:
+                    break
+                _, ftype, stream, length = HEADER.unpack_from(buf)
+                if len(buf) < HEADER.size + length:
+                    break
+                payload = bytes(buf[HEADER.size:HEADER.size + length])
+                del buf[:HEADER.size + length]
+                self._frame(ftype, stream, payload)
+
+    def _frame(self, ftype, stream, payload):
+        with self.cond:
+            if ftype == TYPE_INFO:
+                version, first, count, _, payload_max = INFO.unpack_from(payload)
+                self.info_reply = {"version": version, "stream_first": first,
+                                   "stream_count": count, "payload_max": payload_max}
+                for s in range(first, first + count):
+                    self.streams.setdefault(s, _Stream()).synced = False
+            elif stream in self.streams or ftype == TYPE_STATS:
+                s = self.streams.setdefault(stream, _Stream())
+                if ftype == TYPE_DATA:
+                    s.rx += payload
+                elif ftype == TYPE_CREDIT:
+                    received, s.limit = CREDIT.unpack_from(payload)
+                    if not s.synced:
+                        s.sent = received
+                        s.synced = True
+                elif ftype == TYPE_STATS:
+                    s.stats = dict(zip(STATS_FIELDS, STATS.unpack_from(payload)))
+            self.cond.notify_all()
+
+    def _wait(self, predicate, timeout):
+        with self.cond:
+            if not self.cond.wait_for(predicate, timeout):
+                raise TimeoutError("no reply from WiSer-USB")
+
+    def info(self):
+        """Queries protocol version and streams, and resynchronizes credits."""
+        self.info_reply = None
+        self._send(TYPE_INFO_REQ, STREAM_NONE)
+        self._wait(lambda: self.info_reply is not None, self.timeout)
+        first = self.info_reply["stream_first"]
+        count = self.info_reply["stream_count"]
+        self._wait(lambda: all(self.streams[s].synced for s in range(first, first + count)), self.timeout)
+        return self.info_reply
+
+    def configure(self, stream, baud, data_bits=8, parity="N", stop_bits=1, hw_flow=False):
+        self._send(TYPE_CONFIG, stream, CONFIG.pack(baud, data_bits, PARITY[parity],
+                                                    STOP_BITS[stop_bits], 1 if hw_flow else 0))
+
+    def set_lines(self, stream, dtr, rts):
+        self._send(TYPE_HW_LINE, stream, HW_LINE.pack(1 if dtr else 0, 1 if rts else 0))
+
+    def stats(self, stream):
+        with self.cond:
+            self.streams.setdefault(stream, _Stream()).stats = None
+        self._send(TYPE_STATS_REQ, stream)
+        self._wait(lambda: self.streams[stream].stats is not None, self.timeout)
+        return self.streams[stream].stats
+
+    def write(self, stream, data, timeout=None):
+        """Sends data to a peer, waiting for credit. Returns bytes sent before timeout."""
+        s = self.streams[stream]
+        data = memoryview(bytes(data))
+        sent = 0
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while sent < len(data):
+            with self.cond:
+                space = lambda: (s.limit - s.sent) & 0xFFFFFFFF
+                left = None if deadline is None else max(0.0, deadline - time.monotonic())
+                if not self.cond.wait_for(lambda: 0 < space() < 0x80000000, left):
+                    break
+                n = min(space(), len(data) - sent, PAYLOAD_MAX)
+                s.sent = (s.sent + n) & 0xFFFFFFFF
+            self._send(TYPE_DATA, stream, data[sent:sent + n])
+            sent += n
+        return sent
+
+    def read(self, stream, size=-1, timeout=0.0):
+        """Returns up to size bytes received from a peer, waiting at most timeout for any."""
+        s = self.streams[stream]
+        with self.cond:
+            self.cond.wait_for(lambda: len(s.rx) > 0, timeout)
+            n = len(s.rx) if size < 0 else min(size, len(s.rx))
+            out = bytes(s.rx[:n])
+            del s.rx[:n]
+        return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="WiSer-USB multiplexer")
+    parser.add_argument("--serial", help="USB serial number of WiSer-USB")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    sub.add_parser("info")
+    p = sub.add_parser("stats")
+    p.add_argument("stream", type=int)
+    p = sub.add_parser("term", help="stdin to stream, stream to stdout")
+    p.add_argument("stream", type=int)
+    p.add_argument("--baud", type=int)
+    args = parser.parse_args()
+
+    mux = WiserMux(args.serial)
+    try:
+        if args.cmd == "info":
+            print(mux.info_reply)
+        elif args.cmd == "stats":
+            print(mux.stats(args.stream))
+        elif args.cmd == "term":
+            if args.baud:
+                mux.configure(args.stream, args.baud)
+
+            def pump():
+                for line in sys.stdin.buffer:
+                    mux.write(args.stream, line)
+            threading.Thread(target=pump, daemon=True).start()
+            while True:
+                data = mux.read(args.stream, timeout=0.1)
+                if data:
+                    sys.stdout.buffer.write(data)
+                    sys.stdout.buffer.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        mux.close()
+
+
+if __name__ == "__main__":
+    main()